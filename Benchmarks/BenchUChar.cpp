@@ -0,0 +1,223 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Measures the time per call of every UChar property lookup and case mapping over several input
+// distributions. Results are written as CSV to stdout:
+//
+//   distribution,function,ns
+//
+// Usage: ustring_bench_uchar [corpus size] [milliseconds per measurement]
+
+#include "UString.h"
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+typedef std::vector<UChar::ValueType> Corpus;
+
+// One line of a typical log file, mixing ASCII with Latin-1, Greek, Cyrillic, Arabic, CJK, Hangul and symbols
+static const char* MixedScriptLine = u8"2017-03-02 12:00:01 INFO id=42 user=José path=/café ά έ ή ί ΰ α "
+                                     u8"Привет мир مرحبا بالعالم 你好世界 안녕하세요 €100 ±5 ∑ …\n";
+
+static std::chrono::milliseconds MeasureTime(250);
+
+// Small deterministic generator so every run measures the same corpus
+class Random
+{
+    public:
+        UChar::ValueType next(UChar::ValueType first, UChar::ValueType last)
+        {
+            mState = mState * 6364136223846793005ull + 1442695040888963407ull;
+            return first + static_cast<UChar::ValueType>((mState >> 33) % (last - first + 1));
+        }
+    private:
+        std::uint64_t   mState = 0x5EED;
+};
+
+static Corpus rangeCorpus(std::size_t size, UChar::ValueType first, UChar::ValueType last)
+{
+    Random random;
+    Corpus corpus;
+    while( corpus.size() < size )
+        corpus.push_back(random.next(first, last));
+    return corpus;
+}
+
+static Corpus latinCorpus(std::size_t size)
+{
+    // Mostly ASCII with accented letters from Latin-1 Supplement and Latin Extended-A/B
+    Random random;
+    Corpus corpus;
+    while( corpus.size() < size )
+        corpus.push_back(random.next(0, 3) == 0 ? random.next(0xC0, 0x24F) : random.next(0x20, 0x7E));
+    return corpus;
+}
+
+static Corpus unassignedCorpus(std::size_t size)
+{
+    Random random;
+    Corpus corpus;
+    while( corpus.size() < size )
+    {
+        UChar::ValueType codePoint = random.next(0, UCHAR_CODE_MAX);
+        if( UChar::getCategory(codePoint) == UChar::Category::OtherNotAssigned )
+            corpus.push_back(codePoint);
+    }
+    return corpus;
+}
+
+static Corpus mixedCorpus(std::size_t size)
+{
+    std::u32string line = UString(MixedScriptLine).toStdU32String();
+    Corpus         corpus;
+    while( corpus.size() < size )
+        corpus.insert(corpus.end(), line.begin(), line.end());
+    corpus.resize(size);
+    return corpus;
+}
+
+template<typename Func>
+static double nanosecondsPerCall(const Corpus& corpus, Func func)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::uint64_t checksum = 0;
+    std::size_t   calls    = 0;
+    auto          start    = Clock::now();
+    auto          elapsed  = Clock::duration::zero();
+
+    do
+    {
+        for( UChar::ValueType ch : corpus )
+            checksum += func(ch);
+        calls  += corpus.size();
+        elapsed = Clock::now() - start;
+    } while( elapsed < MeasureTime );
+
+    // Keep the optimizer from discarding the lookups
+    if( checksum == 0xFFFFFFFFFFFFFFFFull )
+        std::cout << "";
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / calls;
+}
+
+template<typename BulkFunc>
+static double nanosecondsPerCodePoint(const Corpus& corpus, BulkFunc func)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::uint8_t> out(corpus.size());
+    std::uint64_t             checksum = 0;
+    std::size_t               calls    = 0;
+    auto                      start    = Clock::now();
+    auto                      elapsed  = Clock::duration::zero();
+
+    do
+    {
+        func(corpus.data(), corpus.size(), out.data());
+        checksum += out[calls % out.size()];
+        calls    += corpus.size();
+        elapsed   = Clock::now() - start;
+    } while( elapsed < MeasureTime );
+
+    if( checksum == 0xFFFFFFFFFFFFFFFFull )
+        std::cout << "";
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / calls;
+}
+
+static void report(const char* distribution, const char* function, double nanoseconds)
+{
+    std::cout << distribution << "," << function << "," << nanoseconds << std::endl;
+}
+
+static void benchmark(const char* name, const Corpus& corpus)
+{
+    typedef UChar::ValueType V;
+
+    report(name, "getCategory",  nanosecondsPerCall(corpus, [](V ch) { return UChar::getCategory(ch); }));
+    report(name, "getDirection", nanosecondsPerCall(corpus, [](V ch) { return UChar::getDirection(ch); }));
+    report(name, "getCase",      nanosecondsPerCall(corpus, [](V ch) { return UChar::getCase(ch); }));
+    report(name, "properties",   nanosecondsPerCall(corpus, [](V ch) {
+                                     UChar::Properties props = UChar::properties(ch);
+                                     return props.category() + props.direction() + props.characterCase(); }));
+    report(name, "toUpper",      nanosecondsPerCall(corpus, [](V ch) { return UChar::toUpper(ch); }));
+    report(name, "toLower",      nanosecondsPerCall(corpus, [](V ch) { return UChar::toLower(ch); }));
+    report(name, "toTitleCase",  nanosecondsPerCall(corpus, [](V ch) { return UChar::toTitleCase(ch); }));
+    report(name, "isSpace",      nanosecondsPerCall(corpus, [](V ch) { return UChar::isSpace(ch); }));
+    report(name, "isLetter",     nanosecondsPerCall(corpus, [](V ch) { return UChar::isLetter(ch); }));
+    report(name, "isControl",    nanosecondsPerCall(corpus, [](V ch) { return UChar::isControl(ch); }));
+    report(name, "isSurrogate",  nanosecondsPerCall(corpus, [](V ch) { return UChar::isSurrogate(ch); }));
+    report(name, "isPunctuation", nanosecondsPerCall(corpus, [](V ch) { return UChar::isPunctuation(ch); }));
+    report(name, "isSymbol",     nanosecondsPerCall(corpus, [](V ch) { return UChar::isSymbol(ch); }));
+    report(name, "isLineBreak",  nanosecondsPerCall(corpus, [](V ch) { return UChar::isLineBreak(ch); }));
+    report(name, "isNumber",     nanosecondsPerCall(corpus, [](V ch) { return UChar::isNumber(ch); }));
+    report(name, "isUpper",      nanosecondsPerCall(corpus, [](V ch) { return UChar::isUpper(ch); }));
+    report(name, "isLower",      nanosecondsPerCall(corpus, [](V ch) { return UChar::isLower(ch); }));
+    report(name, "isTitleCase",  nanosecondsPerCall(corpus, [](V ch) { return UChar::isTitleCase(ch); }));
+    report(name, "classify",     nanosecondsPerCodePoint(corpus, &UChar::classify));
+    report(name, "isSpaceMask",  nanosecondsPerCodePoint(corpus, &UChar::isSpaceMask));
+    report(name, "isLetterMask", nanosecondsPerCodePoint(corpus, &UChar::isLetterMask));
+    report(name, "isNumberMask", nanosecondsPerCodePoint(corpus, &UChar::isNumberMask));
+    report(name, "isPunctuationMask", nanosecondsPerCodePoint(corpus, &UChar::isPunctuationMask));
+    report(name, "isSymbolMask", nanosecondsPerCodePoint(corpus, &UChar::isSymbolMask));
+    report(name, "isControlMask", nanosecondsPerCodePoint(corpus, &UChar::isControlMask));
+}
+
+// Parses a positive decimal argument, returns false if arg is anything else
+static bool parseCount(const char* arg, unsigned long& value)
+{
+    // strtoul skips spaces and accepts a sign, so the first character is checked separately
+    if( !std::isdigit(static_cast<unsigned char>(arg[0])) )
+        return false;
+
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoul(arg, &end, 10);
+    return( *end == '\0' && errno == 0 && value >= 1 );
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long corpusSize   = 65536;
+    unsigned long milliseconds = MeasureTime.count();
+    if( argc > 3 || (argc > 1 && !parseCount(argv[1], corpusSize)) || (argc > 2 && !parseCount(argv[2], milliseconds)) )
+    {
+        std::cerr << "Usage: " << argv[0] << " [corpus size] [milliseconds per measurement]" << std::endl
+                  << "  Both values must be positive integers, the defaults are 65536 and 250" << std::endl;
+        return 1;
+    }
+    MeasureTime = std::chrono::milliseconds(milliseconds);
+
+    std::cout << "distribution,function,ns" << std::endl;
+    benchmark("ascii",      rangeCorpus(corpusSize, 0x20, 0x7E));
+    benchmark("latin",      latinCorpus(corpusSize));
+    benchmark("cjk",        rangeCorpus(corpusSize, 0x4E00, 0x9FFF));
+    benchmark("emoji",      rangeCorpus(corpusSize, 0x1F300, 0x1FAFF));
+    benchmark("unassigned", unassignedCorpus(corpusSize));
+    benchmark("mixed",      mixedCorpus(corpusSize));
+    return 0;
+}
@@ -0,0 +1,242 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _USTRING_SHAREDUSTRING_H_
+#define _USTRING_SHAREDUSTRING_H_
+
+    #include "UString.h"
+    #include <memory>
+    #include <type_traits>
+    #include <utility>
+
+    /*! True if constructing an object through Allocator passes the allocator to the object's constructor by itself
+     *
+     * This is uses-allocator construction, done by std::pmr::polymorphic_allocator. The allocator must not be
+     * passed explicitly in that case, the constructor would receive it twice.
+     */
+    template<typename Allocator>
+    struct UStringConstructPassesAllocator : std::false_type { };
+
+    #if __cplusplus >= 201703L && defined(__has_include)
+        #if __has_include(<memory_resource>)
+            template<typename T>
+            struct UStringConstructPassesAllocator<std::pmr::polymorphic_allocator<T>> : std::true_type { };
+        #endif
+    #endif
+
+    /*! Immutable UTF-8 string whose copies share one buffer
+     *
+     * Copying a shared string only increments an atomic reference count, which makes it cheap to hand the same
+     * string to many consumers. The string is read through get(), the mutating methods first copy the buffer if
+     * it is shared with another object (detach-on-write) and leave every other copy unchanged.
+     *
+     * Copies can be read from several threads at once. A single object must not be modified while another thread
+     * reads or copies it: whether the buffer is shared is decided from the reference count, so a copy made during
+     * a modification may see the change.
+     */
+    template<typename Allocator = std::allocator<char>>
+    class BasicSharedUString
+    {
+        public:
+            typedef BasicUString<Allocator> StringType;
+
+            /*! Create an empty string
+             * @param alloc Allocator used for the buffer
+             */
+            explicit BasicSharedUString(const Allocator& alloc = Allocator())
+                : mString(makeString(alloc))
+            {
+            }
+            /*! Create a shared string holding a copy of str
+             * @param str String to copy
+             */
+            BasicSharedUString(const StringType& str)
+                : mString(makeString(str.get_allocator(), str))
+            {
+            }
+            /*! Create a shared string by taking over the buffer of str
+             * @param str String to move from
+             */
+            BasicSharedUString(StringType&& str)
+                : mString(makeString(str.get_allocator(), std::move(str)))
+            {
+            }
+            /*! Create a shared string holding a copy of a C-string
+             * @param cstr C-string to copy
+             */
+            BasicSharedUString(const char* cstr)
+                : BasicSharedUString(StringType(cstr))
+            {
+            }
+
+            /*! Get the string
+             * @return Reference to the shared string, valid until this object is modified or destroyed
+             */
+            const StringType& get() const               { return *mString; }
+            const StringType& operator*() const         { return *mString; }
+            const StringType* operator->() const        { return mString.get(); }
+            operator const StringType&() const          { return *mString; }
+
+            /*! Check if the buffer is shared with another object
+             *
+             * This reads the reference count, it is only exact while no other thread copies this object.
+             * @return True if a mutating method would copy the buffer
+             */
+            bool isShared() const                       { return( mString.use_count() > 1 ); }
+
+            /*! Modify the string, copying the buffer first if it is shared
+             *
+             * This object must not be copied by another thread during the call, see isShared().
+             * @param edit Function called with a reference to the string that can be modified
+             * @return Reference to this object
+             */
+            template<typename Edit>
+            BasicSharedUString& modify(Edit edit)
+            {
+                if( isShared() )
+                    mString = makeString(mString->get_allocator(), *mString);
+
+                edit(*mString);
+                return *this;
+            }
+
+            /*! Replace the string without copying or modifying the old buffer
+             * @param str String to copy
+             * @return Reference to this object
+             */
+            BasicSharedUString& operator=(const StringType& str)
+            {
+                return( *this = BasicSharedUString(str) );
+            }
+            /*! Replace the string by taking over the buffer of str
+             * @param str String to move from
+             * @return Reference to this object
+             */
+            BasicSharedUString& operator=(StringType&& str)
+            {
+                return( *this = BasicSharedUString(std::move(str)) );
+            }
+
+            /*! Replace the string with a copy of a C-string
+             * @param cstr C-string to copy
+             * @return Reference to this object
+             */
+            BasicSharedUString& operator=(const char* cstr)
+            {
+                return( *this = BasicSharedUString(cstr) );
+            }
+
+            /*! See BasicUString::append()
+             * @return Reference to this object
+             */
+            template<typename T>
+            BasicSharedUString& append(const T& str)    { return modify([&](StringType& s) { s.append(str); }); }
+            /*! See BasicUString::prepend()
+             * @return Reference to this object
+             */
+            template<typename T>
+            BasicSharedUString& prepend(const T& str)   { return modify([&](StringType& s) { s.prepend(str); }); }
+            /*! See BasicUString::insert()
+             * @return Reference to this object
+             */
+            template<typename Where>
+            BasicSharedUString& insert(const StringType& str, Where where)
+            {
+                return modify([&](StringType& s) { s.insert(str, where); });
+            }
+            /*! See BasicUString::replace()
+             * @return Reference to this object
+             */
+            template<typename Start, typename Stop>
+            BasicSharedUString& replace(Start start, Stop stop, const StringType& with)
+            {
+                return modify([&](StringType& s) { s.replace(start, stop, with); });
+            }
+            /*! See BasicUString::replaceAll()
+             * @return Reference to this object
+             */
+            BasicSharedUString& replaceAll(const StringType& what, const StringType& with, std::size_t start=0)
+            {
+                return modify([&](StringType& s) { s.replaceAll(what, with, start); });
+            }
+            /*! See BasicUString::erase()
+             * @return Reference to this object
+             */
+            template<typename Start, typename Stop>
+            BasicSharedUString& erase(Start start, Stop stop)
+            {
+                return modify([&](StringType& s) { s.erase(start, stop); });
+            }
+            /*! See BasicUString::clear()
+             * @return Reference to this object
+             */
+            BasicSharedUString& clear()                 { return modify([](StringType& s) { s.clear(); }); }
+            /*! See BasicUString::toUpper()
+             * @return Reference to this object
+             */
+            BasicSharedUString& toUpper()               { return modify([](StringType& s) { s.toUpper(); }); }
+            /*! See BasicUString::toLower()
+             * @return Reference to this object
+             */
+            BasicSharedUString& toLower()               { return modify([](StringType& s) { s.toLower(); }); }
+            /*! See BasicUString::toTitleCase()
+             * @return Reference to this object
+             */
+            BasicSharedUString& toTitleCase()           { return modify([](StringType& s) { s.toTitleCase(); }); }
+
+            /*! Compare two shared strings, this is a pointer comparison if they share a buffer
+             * @return True if the strings are equal
+             */
+            friend bool operator==(const BasicSharedUString& str1, const BasicSharedUString& str2)
+            {
+                return( str1.mString == str2.mString || *str1.mString == *str2.mString );
+            }
+            friend bool operator!=(const BasicSharedUString& str1, const BasicSharedUString& str2)
+            {
+                return !( str1 == str2 );
+            }
+        private:
+            /*! Allocate a string with alloc, args are the constructor arguments before the allocator
+             */
+            template<typename... Args>
+            static std::shared_ptr<StringType> makeString(const Allocator& alloc, Args&&... args)
+            {
+                return makeString(UStringConstructPassesAllocator<Allocator>(), alloc, std::forward<Args>(args)...);
+            }
+            template<typename... Args>
+            static std::shared_ptr<StringType> makeString(std::true_type, const Allocator& alloc, Args&&... args)
+            {
+                return std::allocate_shared<StringType>(alloc, std::forward<Args>(args)...);
+            }
+            template<typename... Args>
+            static std::shared_ptr<StringType> makeString(std::false_type, const Allocator& alloc, Args&&... args)
+            {
+                return std::allocate_shared<StringType>(alloc, std::forward<Args>(args)..., alloc);
+            }
+
+            std::shared_ptr<StringType> mString;
+    };
+
+    //! Shared immutable string using std::allocator
+    typedef BasicSharedUString<std::allocator<char>> SharedUString;
+
+#endif
@@ -24,6 +24,7 @@
 #ifndef _USTRING_UCHAR_H_
 #define _USTRING_UCHAR_H_
 
+    #include <cstddef>
     #include <cstdint>
     #include <map>
     #include "UnicodeData.h"
@@ -34,6 +35,20 @@
         #define USTRING_NOEXCEPT
     #endif
 
+    #if defined(HAVE_CONSTEXPR)
+        #define USTRING_CONSTEXPR constexpr
+    #else
+        #define USTRING_CONSTEXPR inline
+    #endif
+
+    // Functions reading the Unicode tables can only be evaluated at compile-time when UnicodeData.h
+    // was generated with --constexpr
+    #if defined(HAVE_CONSTEXPR) && defined(USTRING_CONSTEXPR_TABLES)
+        #define USTRING_TABLE_CONSTEXPR constexpr
+    #else
+        #define USTRING_TABLE_CONSTEXPR inline
+    #endif
+
     /*! UChar is used to represent a UTF-8 character
      */ 
     class UChar
@@ -125,27 +140,36 @@
 
             /*! Create a character with a Null value
              */
-            UChar() USTRING_NOEXCEPT;
+            USTRING_CONSTEXPR UChar() USTRING_NOEXCEPT : mChar(UCHAR_CODE_NULL) { }
             /*! Create a character from the given code-point
              * @param codePoin The UTF-8 code-point
              */
-            UChar(ValueType codePoint) USTRING_NOEXCEPT;
+            USTRING_CONSTEXPR UChar(ValueType codePoint) USTRING_NOEXCEPT : mChar(codePoint) { }
             
             /*! Get the unicode Category of a given code-point
              * @param ch The code-point
              * @return The unicode Category
              */
-            static Category  getCategory(ValueType ch);
+            static USTRING_TABLE_CONSTEXPR Category getCategory(ValueType ch)
+            {
+                return static_cast<Category>(findProperty(ch).category);
+            }
             /*! Get the unicode Direction of a given code-point
              * @param ch The code-point
              * @return The unicode Direction
              */
-            static Direction getDirection(ValueType ch);
+            static USTRING_TABLE_CONSTEXPR Direction getDirection(ValueType ch)
+            {
+                return static_cast<Direction>(findProperty(ch).direction);
+            }
             /*! Get the unicode Case of a given code-point
              * @param ch The code-point
              * @return The unicode Case
              */
-            static Case      getCase(ValueType ch);
+            static USTRING_TABLE_CONSTEXPR Case getCase(ValueType ch)
+            {
+                return static_cast<Case>(findProperty(ch).characterCase);
+            }
 
             /*! Get the unicode Category of this char
              * @return The unicode Category
@@ -159,6 +183,48 @@
              * @return The unicode Case
              */
             inline Case      getCase() const { return getCase(mChar); }
+
+            /*! Every property of a code-point, read with a single table lookup
+             */
+            class Properties
+            {
+                public:
+                    USTRING_CONSTEXPR Properties(ValueType codePoint, const UCharProperty& property) USTRING_NOEXCEPT
+                        : mCodePoint(codePoint), mProperty(property) { }
+
+                    USTRING_CONSTEXPR Category  category() const { return static_cast<Category>(mProperty.category); }
+                    USTRING_CONSTEXPR Direction direction() const { return static_cast<Direction>(mProperty.direction); }
+                    USTRING_CONSTEXPR Case      characterCase() const { return static_cast<Case>(mProperty.characterCase); }
+
+                    USTRING_TABLE_CONSTEXPR ValueType toUpper() const
+                    {
+                        return static_cast<ValueType>(mCodePoint + UCharCaseMappings[mProperty.caseMapping].upperDelta);
+                    }
+                    USTRING_TABLE_CONSTEXPR ValueType toLower() const
+                    {
+                        return static_cast<ValueType>(mCodePoint + UCharCaseMappings[mProperty.caseMapping].lowerDelta);
+                    }
+                    USTRING_TABLE_CONSTEXPR ValueType toTitleCase() const
+                    {
+                        return static_cast<ValueType>(mCodePoint + UCharCaseMappings[mProperty.caseMapping].titleDelta);
+                    }
+                private:
+                    ValueType               mCodePoint;
+                    const UCharProperty&    mProperty;
+            };
+
+            /*! Get the Category, Direction, Case and case mappings of a code-point at once
+             * @param codePoint The code-point
+             * @return The properties of the code-point
+             */
+            static USTRING_TABLE_CONSTEXPR Properties properties(ValueType codePoint)
+            {
+                return Properties(codePoint, findProperty(codePoint));
+            }
+            /*! Get the Category, Direction, Case and case mappings of this char at once
+             * @return The properties of this char
+             */
+            inline Properties properties() const { return properties(mChar); }
             
             /*! Assign another UChar to this one
              * @return A reference to this object
@@ -172,33 +238,42 @@
             /*! Compare this character to another
              * @return True if it is equal, False if it isn't
              */
-            inline const bool operator==(UChar codePoint) const { return( mChar == codePoint ); }
+            USTRING_CONSTEXPR const bool operator==(UChar codePoint) const { return( mChar == codePoint ); }
 
             /*! Compare this character to another
              * @return True if it is equal, False if it isn't
              */
-            inline const bool operator==(int codePoint) const { return( mChar == codePoint ); }
+            USTRING_CONSTEXPR const bool operator==(int codePoint) const { return( mChar == codePoint ); }
 
             /*! Compare this character to another
              * @return True if it is not equal, False if it is equal
              */
-            inline const bool operator!=(UChar codePoint) const { return( mChar != codePoint ); }
+            USTRING_CONSTEXPR const bool operator!=(UChar codePoint) const { return( mChar != codePoint ); }
 
             /*! Convert a code point to the upper case version
              * @param codePoint The code-point to convert
              * @return A Uchar containing the uppercase version 
              */
-            static UChar toUpper(ValueType codePoint);
+            static USTRING_TABLE_CONSTEXPR UChar toUpper(ValueType codePoint)
+            {
+                return UChar(static_cast<ValueType>(codePoint + findCaseMapping(codePoint).upperDelta));
+            }
             /*! Convert a code point to the lower case version
              * @param codePoint The code-point to convert
              * @return A Uchar containing the lowercase version 
              */
-            static UChar toLower(ValueType codePoint);
+            static USTRING_TABLE_CONSTEXPR UChar toLower(ValueType codePoint)
+            {
+                return UChar(static_cast<ValueType>(codePoint + findCaseMapping(codePoint).lowerDelta));
+            }
             /*! Convert a code point to the title case version
              * @param codePoint The code-point to convert
              * @return A Uchar containing the titlecase version 
              */
-            static UChar toTitleCase(ValueType codePoint);
+            static USTRING_TABLE_CONSTEXPR UChar toTitleCase(ValueType codePoint)
+            {
+                return UChar(static_cast<ValueType>(codePoint + findCaseMapping(codePoint).titleDelta));
+            }
             /*! Return a new UChar containing a uppercase version of this 
              * @return A Uchar containing the uppercase version 
              */
@@ -212,19 +287,73 @@
              */
             inline UChar toTitleCase() const { return toTitleCase(mChar); }
             
-            // Is?? functions
-            static bool isNull(ValueType codePoint);
-            static bool isSpace(ValueType codePoint);        
-            static bool isLetter(ValueType codePoint);
-            static bool isControl(ValueType codePoint);
-            static bool isSurrogate(ValueType codePoint);
-            static bool isPunctuation(ValueType codePoint);
-            static bool isSymbol(ValueType codePoint);
-            static bool isLineBreak(ValueType codePoint);
-            static bool isNumber(ValueType codePoint);
-            static bool isUpper(ValueType codePoint);
-            static bool isLower(ValueType codePoint);
-            static bool isTitleCase(ValueType codePoint);
+            // Is?? functions, code-points up to U+00FF are answered from UCharLatin1Flags
+            static USTRING_CONSTEXPR bool isNull(ValueType codePoint) { return( codePoint == UCHAR_CODE_NULL ); }
+
+            static USTRING_TABLE_CONSTEXPR bool isSpace(ValueType codePoint)
+            {
+                return( codePoint <= UCHAR_LATIN1_MAX ? (UCharLatin1Flags[codePoint] & UCHAR_FLAG_SPACE) != 0
+                                                      : isCategoryBetween(codePoint, SeparatorSpace, SeparatorSpace) );
+            }
+
+            static USTRING_TABLE_CONSTEXPR bool isLetter(ValueType codePoint)
+            {
+                return( codePoint <= UCHAR_LATIN1_MAX ? (UCharLatin1Flags[codePoint] & UCHAR_FLAG_LETTER) != 0
+                                                      : isCategoryBetween(codePoint, LetterUppercase, LetterOther) );
+            }
+
+            static USTRING_TABLE_CONSTEXPR bool isControl(ValueType codePoint)
+            {
+                return( codePoint <= UCHAR_LATIN1_MAX ? (UCharLatin1Flags[codePoint] & UCHAR_FLAG_CONTROL) != 0
+                                                      : isCategoryBetween(codePoint, OtherControl, OtherFormat) );
+            }
+
+            static USTRING_TABLE_CONSTEXPR bool isSurrogate(ValueType codePoint)
+            {
+                return( codePoint <= UCHAR_LATIN1_MAX ? false
+                                                      : isCategoryBetween(codePoint, OtherSurrogate, OtherSurrogate) );
+            }
+
+            static USTRING_TABLE_CONSTEXPR bool isPunctuation(ValueType codePoint)
+            {
+                return( codePoint <= UCHAR_LATIN1_MAX ? (UCharLatin1Flags[codePoint] & UCHAR_FLAG_PUNCTUATION) != 0
+                                                      : isCategoryBetween(codePoint, PunctuationConnector, PunctuationOther) );
+            }
+
+            static USTRING_TABLE_CONSTEXPR bool isSymbol(ValueType codePoint)
+            {
+                return( codePoint <= UCHAR_LATIN1_MAX ? (UCharLatin1Flags[codePoint] & UCHAR_FLAG_SYMBOL) != 0
+                                                      : isCategoryBetween(codePoint, SymbolMath, SymbolOther) );
+            }
+
+            static USTRING_TABLE_CONSTEXPR bool isLineBreak(ValueType codePoint)
+            {
+                return( codePoint <= UCHAR_LATIN1_MAX ? false
+                                                      : isCategoryBetween(codePoint, SeparatorLine, SeparatorParagraph) );
+            }
+
+            static USTRING_TABLE_CONSTEXPR bool isNumber(ValueType codePoint)
+            {
+                return( codePoint <= UCHAR_LATIN1_MAX ? (UCharLatin1Flags[codePoint] & UCHAR_FLAG_NUMBER) != 0
+                                                      : isCategoryBetween(codePoint, NumberDecimalDigit, NumberOther) );
+            }
+
+            static USTRING_TABLE_CONSTEXPR bool isUpper(ValueType codePoint)
+            {
+                return( codePoint <= UCHAR_LATIN1_MAX ? (UCharLatin1Flags[codePoint] & UCHAR_FLAG_UPPER) != 0
+                                                      : isCaseEqual(codePoint, CaseUpper) );
+            }
+
+            static USTRING_TABLE_CONSTEXPR bool isLower(ValueType codePoint)
+            {
+                return( codePoint <= UCHAR_LATIN1_MAX ? (UCharLatin1Flags[codePoint] & UCHAR_FLAG_LOWER) != 0
+                                                      : isCaseEqual(codePoint, CaseLower) );
+            }
+
+            static USTRING_TABLE_CONSTEXPR bool isTitleCase(ValueType codePoint)
+            {
+                return isCaseEqual(codePoint, CaseTitle);
+            }
             
             inline bool isUpper() { return isUpper(mChar); }
             inline bool isLower() { return isLower(mChar); }
@@ -238,40 +367,63 @@
             inline bool isLineBreak() const { return isLineBreak(mChar); }
             inline bool isNumber() const { return isNumber(mChar); }
             inline bool isNull() const { return isNull(mChar); }
+
+            /*! Get the unicode Category of every code-point in a buffer
+             * @param codePoints The code-points to classify
+             * @param count The number of code-points
+             * @param categories Receives count Category values
+             */
+            static void classify(const ValueType* codePoints, std::size_t count, std::uint8_t* categories);
+
+            // Bulk Is?? functions, writes 1 to mask[i] if codePoints[i] matches, 0 otherwise
+            static void isSpaceMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask);
+            static void isLetterMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask);
+            static void isNumberMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask);
+            static void isPunctuationMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask);
+            static void isSymbolMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask);
+            static void isControlMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask);
             
             // Type casting operators
-            inline operator ValueType() { return mChar; }
+            USTRING_CONSTEXPR operator ValueType() const { return mChar; }
         private:
-            static inline bool isCodePointInArray(UCharEntry *array, std::size_t arraySize, UChar::ValueType codePoint)
+            static USTRING_TABLE_CONSTEXPR bool isCategoryBetween(ValueType codePoint, Category first, Category last)
             {
-                for( std::uint32_t i=0; i<arraySize; i++ )
-                {
-                    if( array[i].codePoint == codePoint )
-                        return true;
-                }
-                return false;
+                return isBetween(findProperty(codePoint).category, first, last);
             }
 
-            static inline UCharLetter* findLetter(ValueType codePoint)
+            static USTRING_CONSTEXPR bool isBetween(std::uint8_t category, Category first, Category last)
             {
-                for( std::uint32_t i=0; i<UCHAR_NUM_LETTERS; i++ )
-                {
-                    if( UCharLetters[i].codePoint == codePoint )
-                        return &UCharLetters[i];
-                }
-                
-                return nullptr;
+                return( category >= first && category <= last );
             }
-            
-            static inline UCharEntry* findEntry(UCharEntry *array, std::size_t arraySize, ValueType codePoint)
+
+            static USTRING_TABLE_CONSTEXPR bool isCaseEqual(ValueType codePoint, Case characterCase)
+            {
+                return( findProperty(codePoint).characterCase == characterCase );
+            }
+
+            static USTRING_TABLE_CONSTEXPR const UCharProperty& findProperty(ValueType codePoint)
+            {
+                return( codePoint <= UCHAR_BMP_MAX
+                            ? UCharProperties[UCharPropertyStage2[(UCharPropertyStage1[codePoint >> UCHAR_PROPERTY_SHIFT] << UCHAR_PROPERTY_SHIFT) |
+                                                                  (codePoint & UCHAR_PROPERTY_MASK)]]
+                            : codePoint <= UCHAR_CODE_MAX
+                                ? UCharProperties[findRange(UCharPropertyRanges, UCHAR_NUM_PROPERTY_RANGES, codePoint) & UCHAR_RANGE_MASK]
+                                : UCharProperties[UCHAR_PROPERTY_INVALID] );
+            }
+
+            static USTRING_TABLE_CONSTEXPR const UCharCaseMapping& findCaseMapping(ValueType codePoint)
+            {
+                return UCharCaseMappings[findProperty(codePoint).caseMapping];
+            }
+
+            /*! Binary search for the last range starting at or before codePoint. The only branch is the loop
+             * (recursion) condition, the half to continue in is selected with a conditional move.
+             */
+            static USTRING_TABLE_CONSTEXPR std::uint32_t findRange(const std::uint32_t* ranges, std::size_t count, ValueType codePoint)
             {
-                for( std::uint32_t i=0; i<arraySize; i++ )
-                {
-                    if( array[i].codePoint == codePoint )
-                        return &array[i];
-                }
-                
-                return nullptr;
+                return( count <= 1 ? ranges[0]
+                                   : findRange((ranges[count / 2] >> UCHAR_RANGE_SHIFT) <= codePoint ? ranges + count / 2 : ranges,
+                                               count - count / 2, codePoint) );
             }
             
             ValueType   mChar;
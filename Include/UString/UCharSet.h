@@ -0,0 +1,155 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _USTRING_UCHARSET_H_
+#define _USTRING_UCHARSET_H_
+
+    #include "UChar.h"
+    #include <cstdint>
+    #include <initializer_list>
+    #include <utility>
+    #include <vector>
+
+    /*! A set of code-points stored as an inversion list
+     *
+     * The set is a sorted list of boundaries, every even entry starts a range of code-points in the set and every
+     * odd entry starts a range that is not, so the list always has an even length. Membership is a binary search over the boundaries, ASCII code-points
+     * are answered from a bitmap instead.
+     */
+    class UCharSet
+    {
+        public:
+            typedef UChar::ValueType ValueType;
+
+            /*! Create an empty set
+             */
+            UCharSet() USTRING_NOEXCEPT;
+            /*! Create a set containing a single range of code-points
+             * @param first The first code-point in the set
+             * @param last The last code-point in the set
+             */
+            UCharSet(ValueType first, ValueType last);
+
+            /*! Create a set containing every code-point of the given categories
+             * @param categories The categories, for example { UChar::LetterUppercase, UChar::NumberDecimalDigit }
+             * @return The set
+             */
+            static UCharSet fromCategories(std::initializer_list<UChar::Category> categories);
+            /*! Create a set containing the given ranges of code-points
+             * @param ranges Pairs of first and last code-points, they may overlap and don't need to be sorted
+             * @return The set
+             */
+            static UCharSet fromRanges(std::initializer_list<std::pair<ValueType, ValueType>> ranges);
+            /*! Create a set containing every code-point the predicate returns true for
+             * @param predicate Callable taking a code-point, for example UChar::isPunctuation
+             * @return The set
+             */
+            template<typename Predicate>
+            static UCharSet fromPredicate(Predicate predicate)
+            {
+                UCharSet set;
+                bool     inSet = false;
+                for( ValueType codePoint = 0; codePoint <= UCHAR_CODE_MAX; codePoint++ )
+                {
+                    if( static_cast<bool>(predicate(codePoint)) != inSet )
+                    {
+                        set.mList.push_back(codePoint);
+                        inSet = !inSet;
+                    }
+                }
+                if( inSet )
+                    set.mList.push_back(UCHAR_CODE_MAX + 1);
+                set.updateAscii();
+                return set;
+            }
+            /*! Create a set containing every code-point the predicate returns true for
+             * @param predicate A function taking a code-point, for example UChar::isPunctuation
+             * @return The set
+             */
+            static UCharSet fromPredicate(bool (*predicate)(ValueType));
+
+            /*! Add a single code-point to the set
+             * @param codePoint The code-point
+             * @return A reference to this set
+             */
+            UCharSet& add(ValueType codePoint);
+            /*! Add a range of code-points to the set
+             * @param first The first code-point of the range
+             * @param last The last code-point of the range
+             * @return A reference to this set
+             */
+            UCharSet& add(ValueType first, ValueType last);
+
+            /*! Create a set containing every code-point in either set
+             * @param other The set to combine with
+             * @return The union of both sets
+             */
+            UCharSet unite(const UCharSet& other) const;
+            /*! Create a set containing every code-point in both sets
+             * @param other The set to combine with
+             * @return The intersection of both sets
+             */
+            UCharSet intersect(const UCharSet& other) const;
+
+            UCharSet  operator|(const UCharSet& other) const { return unite(other); }
+            UCharSet  operator&(const UCharSet& other) const { return intersect(other); }
+            UCharSet& operator|=(const UCharSet& other) { return( *this = unite(other) ); }
+            UCharSet& operator&=(const UCharSet& other) { return( *this = intersect(other) ); }
+
+            /*! Check if a code-point is in the set
+             * @param codePoint The code-point
+             * @return True if it is in the set
+             */
+            bool contains(ValueType codePoint) const
+            {
+                return( codePoint < 0x80 ? ((mAscii[codePoint >> 6] >> (codePoint & 0x3F)) & 1) != 0
+                                         : containsNonAscii(codePoint) );
+            }
+            /*! Check if a character is in the set
+             * @param ch The character
+             * @return True if it is in the set
+             */
+            bool contains(UChar ch) const { return contains(static_cast<ValueType>(ch)); }
+
+            /*! Check if the set contains no code-points
+             * @return True if the set is empty
+             */
+            bool isEmpty() const { return mList.empty(); }
+            /*! Get the number of distinct ranges in the set
+             * @return The number of ranges
+             */
+            std::size_t rangeCount() const { return( mList.size() / 2 ); }
+
+            bool operator==(const UCharSet& other) const { return( mList == other.mList ); }
+            bool operator!=(const UCharSet& other) const { return( mList != other.mList ); }
+        private:
+            template<typename Operation>
+            UCharSet combine(const UCharSet& other, Operation operation) const;
+
+            bool containsNonAscii(ValueType codePoint) const;
+            void updateAscii();
+
+            std::vector<ValueType>  mList;
+            std::uint64_t           mAscii[2];
+    };
+
+#endif
@@ -52,16 +52,29 @@
      */
 
     #include "UChar.h"
+    #include "UStringView.h"
     #include "utf8/utf8.h"
     #include <string>
+    #include <vector>
+    #include <atomic>
+    #include <memory>
+    #include <ostream>
     #include <cstdint>
 
     /*! UTF-8 Encoded String
+     *
+     * The bytes are stored in a std::basic_string using Allocator, and every string the class creates for its own
+     * use or returns is constructed with the allocator of the string it came from. Most code uses the UString alias
+     * for std::allocator<char>, which is compiled into the library.
      */
-    class UString
+    template<typename Allocator = std::allocator<char>>
+    class BasicUString
     {
         public:
             typedef UChar value_type;
+            typedef Allocator allocator_type;
+            //! Type of the string holding the UTF-8 bytes
+            typedef std::basic_string<char, std::char_traits<char>, Allocator> StringType;
 
             /*! Base class for Iterators used in UString
              *
@@ -119,7 +132,7 @@
                     }
 
                 private:
-                    friend class UString;
+                    friend class BasicUString<Allocator>;
 
                     IteratorBase(const IterType& begin, const IterType& end, const IterType& pos)
                         : mRangeStart(begin), mRangeEnd(end), mIter(pos)
@@ -168,35 +181,101 @@
                     bool operator==(const ReverseIteratorBase& other)   { return( other.base() == this->base() ); }
             };
 
-            using Iterator              = IteratorBase<std::string::iterator>;
-            using ConstIterator         = IteratorBase<std::string::const_iterator>;
+            using Iterator              = IteratorBase<typename StringType::iterator>;
+            using ConstIterator         = IteratorBase<typename StringType::const_iterator>;
             using ReverseIterator       = ReverseIteratorBase<Iterator>;
             using ConstReverseIterator  = ReverseIteratorBase<ConstIterator>;
 
             /*! Default constructor which creates an empty string.
              */
-            UString() { }
+            BasicUString() { }
+            /*! Create an empty string using a allocator
+             * @param alloc Allocator used for the bytes of the string
+             */
+            explicit BasicUString(const Allocator& alloc) : mData(alloc) { }
 
             /*! Construct a UString as a copy of another UString.
              * @param other UString to copy
              */
-            UString(const UString& other) USTRING_NOEXCEPT;
-            /*! Construct a UString as a copy of another UString.
+            BasicUString(const BasicUString& other) USTRING_NOEXCEPT;
+            /*! Construct a UString as a copy of another UString using a different allocator.
+             * @param other UString to copy
+             * @param alloc Allocator used for the bytes of the string
+             */
+            BasicUString(const BasicUString& other, const Allocator& alloc) USTRING_NOEXCEPT;
+            /*! Construct a UString by taking over the contents of another UString.
+             * @param other UString to move from, it is left empty
+             */
+            BasicUString(BasicUString&& other) USTRING_NOEXCEPT;
+            /*! Construct a UString by taking over the contents of another UString using a different allocator.
+             *
+             * The bytes are copied if the allocators are not equal.
+             * @param other UString to move from
+             * @param alloc Allocator used for the bytes of the string
+             */
+            BasicUString(BasicUString&& other, const Allocator& alloc) USTRING_NOEXCEPT;
+            /*! Construct a UString as a copy of a C string.
              * @param cstr C-string to copy.
+             * @param alloc Allocator used for the bytes of the string
              */
-            UString(const char *cstr) USTRING_NOEXCEPT;
+            BasicUString(const char *cstr, const Allocator& alloc = Allocator()) USTRING_NOEXCEPT;
 
             /*! Construct a UString from a std::string
              * @param str std::string to copy.
              */
-            UString(const std::string& str) USTRING_NOEXCEPT;
+            BasicUString(const StringType& str) USTRING_NOEXCEPT;
+            /*! Construct a UString by taking over the buffer of a std::string
+             * @param str std::string to move from
+             */
+            BasicUString(StringType&& str) USTRING_NOEXCEPT;
+            /*! Construct a UString holding a copy of the bytes of a view
+             * @param view View to copy
+             * @param alloc Allocator used for the bytes of the string
+             */
+            explicit BasicUString(UStringView view, const Allocator& alloc = Allocator());
 
-            /*! Construct a UString as a copy of a C string.
+            /*! Construct a UString containing a single character.
              * @param ch UChar character to assign
+             * @param alloc Allocator used for the bytes of the string
              */
-            explicit UString(UChar ch) USTRING_NOEXCEPT;
+            explicit BasicUString(UChar ch, const Allocator& alloc = Allocator()) USTRING_NOEXCEPT;
+            ~BasicUString();
             
-            static const size_t npos = std::string::npos;
+            static const size_t npos = StringType::npos;
+
+            /*! Position of a character in a string, stored as a byte offset
+             *
+             * Positions are returned by the Position overloads of find() and findLastOf() and can be passed
+             * to subStr(), replace(), erase() and insert() without counting characters from the beginning of
+             * the string again. A Position is only valid for the string it came from, and only until that
+             * string is modified.
+             */
+            class Position
+            {
+                public:
+                    /*! Create a position pointing at the beginning of a string
+                     */
+                    Position() : mOffset(0) { }
+                    /*! Create a position from a byte offset
+                     * @param byteOffset Offset of the first byte of a character, or npos
+                     */
+                    explicit Position(std::size_t byteOffset) : mOffset(byteOffset) { }
+
+                    /*! Get the byte offset into the string
+                     * @return The byte offset, or npos if the position is invalid
+                     */
+                    std::size_t byteOffset() const { return mOffset; }
+                    /*! Check if the position points into a string, find() returns an invalid position if nothing was found
+                     * @return True if the position is valid
+                     */
+                    bool isValid() const { return( mOffset != npos ); }
+
+                    bool operator==(const Position& other) const { return( mOffset == other.mOffset ); }
+                    bool operator!=(const Position& other) const { return( mOffset != other.mOffset ); }
+                    bool operator<(const Position& other) const { return( mOffset < other.mOffset ); }
+                private:
+                    std::size_t mOffset;
+            };
 
             /*! Inserts other string into this one at the given position
              *
@@ -205,58 +284,84 @@
              * @param pos Position of the string to insert at
              * @return Reference to this object
              */
-            UString& insert(const UString& other, std::size_t pos);
+            BasicUString& insert(const BasicUString& other, std::size_t pos);
+            /*! Inserts other string into this one at the given position
+             * @param other String to insert
+             * @param pos Position to insert the string at
+             * @return Reference to this object
+             */
+            BasicUString& insert(const BasicUString& other, Position pos);
 
 
             /*! Assigns other to this string
              * @param other String to assign
              * @return Reference to this object
              */
-            UString& assign(const UString& other);
+            BasicUString& assign(const BasicUString& other);
             /*! Assigns other to this string
              * @param other String to assign
              * @return Reference to this object
              */
-            UString& assign(const char* other);
+            BasicUString& assign(const char* other);
+            /*! Assigns other to this string by taking over its contents
+             * @param other String to move from, it is left empty
+             * @return Reference to this object
+             */
+            BasicUString& assign(BasicUString&& other) USTRING_NOEXCEPT;
             /*! Assigns other to this string
              * @param other String to assign
              * @return Reference to this object
              */
-            UString& operator=(const UString& other);
+            BasicUString& operator=(const BasicUString& other);
             /*! Assigns other to this string
              * @param other String to assign
              * @return Reference to this object
              */
-            UString& operator=(const char* other);
+            BasicUString& operator=(const char* other);
+            /*! Assigns other to this string by taking over its contents
+             * @param other String to move from, it is left empty
+             * @return Reference to this object
+             */
+            BasicUString& operator=(BasicUString&& other) USTRING_NOEXCEPT;
 
-            int compare(const UString& other) const;
+            int compare(const BasicUString& other) const;
 
             /*! Append a character to the current string
              * @param ch Character to append
              * @return Reference to this object
              */
-            UString& append(UChar ch);
+            BasicUString& append(UChar ch);
             /*! Append a string to the current string
              * @param str String to append
              * @return Reference to this object
              */
-            UString& append(const UString& str);
+            BasicUString& append(const BasicUString& str);
+            /*! Append a string to the current string, taking over its buffer if this string is empty
+             * @param str String to append
+             * @return Reference to this object
+             */
+            BasicUString& append(BasicUString&& str);
 
             /*! Append a C-string to the current string
              * @param str C-string string to append
              * @return Reference to this object
              */
-            UString& append(const char* str);
+            BasicUString& append(const char* str);
             /*! Append a C-string to the current string
              * @param str C-string string to append
              * @return Reference to this object
              */
-            UString& operator+=(const char *str);
+            BasicUString& operator+=(const char *str);
             /*! Append a string to the current string
              * @param str String to append
              * @return Reference to this object
              */
-            UString& operator+=(const UString& str);
+            BasicUString& operator+=(const BasicUString& str);
+            /*! Append a string to the current string
+             * @param str String to append
+             * @return Reference to this object
+             */
+            BasicUString& operator+=(BasicUString&& str);
 
             /*! Append a string to the current string
              *
@@ -269,23 +374,23 @@
              * This is provided for STL compatibility and simply calls append()
              * @param str String to append
              */
-            void push_back(const UString& str);
+            void push_back(const BasicUString& str);
 
             /*! Prepend a character to the current string
              * @param ch Character to prepend
              * @return Reference to this object
              */
-            UString& prepend(UChar ch);
+            BasicUString& prepend(UChar ch);
             /*! Prepend a string to the current string
              * @param str String to prepend
              * @return Reference to this object
              */
-            UString& prepend(const UString& str);
+            BasicUString& prepend(const BasicUString& str);
             /*! Prepend a C-string to the current string
              * @param str C-string to prepend
              * @return Reference to this object
              */
-            UString& prepend(const char* str);
+            BasicUString& prepend(const char* str);
 
             /*! Prepend a UChar to the current string
              *
@@ -298,12 +403,12 @@
              * This is provieded for STL compatibility and simply calls prepend()
              * @param str UString to append
              */
-            void push_front(const UString& str);
+            void push_front(const BasicUString& str);
 
             /*! Check if this string equals the other.
              * @return True if equal, False if not
              */
-            bool operator==(const UString& other) const;
+            bool operator==(const BasicUString& other) const;
             /*! Check if this string equals the other.
              * @return True if equal, False if not
              */
@@ -311,16 +416,33 @@
             /*! Check if this string not equals the other.
              * @return True if not equal, False if equal
              */
-            bool operator!=(const UString& other) const;
+            bool operator!=(const BasicUString& other) const;
             /*! Check if this string not equals the other.
              * @return True if not equal, False if equal
              */
             bool operator!=(const char* other) const;
 
             /*! Convert to std::string.
-             * @return std::string
+             * @return std::string, or the std::basic_string using Allocator
+             */
+            const StringType& toStdString() const;
+            /*! Take the buffer out of this string without copying it
+             *
+             * Only callable on an rvalue, for example std::move(str).release(). The string is left empty.
+             * @return std::string holding the UTF-8 bytes
              */
-            const std::string& toStdString() const;
+            StringType release() &&;
+            /*! Create a UString that takes over the buffer of a std::string without copying it
+             * @param str std::string holding UTF-8 bytes, it is left empty
+             * @param validate Check that str is valid UTF-8 before taking it over
+             * @return The new string
+             * @throws utf8::invalid_utf8 if validate is true and str is not valid UTF-8, str is not changed then
+             */
+            static BasicUString adopt(StringType&& str, bool validate=false);
+            /*! Get a view of the bytes of this string, it is valid until the string is modified
+             * @return UStringView
+             */
+            operator UStringView() const USTRING_NOEXCEPT { return UStringView(mData.data(), mData.size(), cachedLength()); }
 
             /*! Convert to UTF-16 and return it as a std::u16string
              * @return std::u16string
@@ -334,30 +456,32 @@
 
             /*! Convert a string from UTF-16 and return a new UTF-8 encoded string
              * @param str UTF-16 encoded string to convert
+             * @param alloc Allocator used for the bytes of the new string
              * @return UTF-16 encoded string
              */
-            static UString fromStdU16String(const std::u16string& str);
+            static BasicUString fromStdU16String(const std::u16string& str, const Allocator& alloc = Allocator());
 
             /*! Convert a string from UTF-32 and return a new UTF-8 encoded string
              * @param str UTF-32 encoded string to convert
+             * @param alloc Allocator used for the bytes of the new string
              * @return New UTF-8 encoded string
              */
-            static UString fromStdU32String(const std::u32string& str);
+            static BasicUString fromStdU32String(const std::u32string& str, const Allocator& alloc = Allocator());
 
             /*! Convert any lowercase characters in the string to upper
              * @return Reference to this object
              */
-            UString& toUpper();
+            BasicUString& toUpper();
 
             /*! Convert any uppercase characters in the string to lower
              * @return Reference to this object
              */
-            UString& toLower();
+            BasicUString& toLower();
 
             /*! Convert string to titleCase
              * @return Reference to this object
              */
-            UString& toTitleCase();
+            BasicUString& toTitleCase();
 
             /*! Get character at position idx
              * @return Character
@@ -373,7 +497,30 @@
              * @param len Number of characters to copy or until the end if len is npos
              * @return New string containing characters copied
              */
-            UString subStr(std::size_t start, std::size_t len=npos) const;
+            BasicUString subStr(std::size_t start, std::size_t len=npos) const;
+            /*! Create a new string using a sub-section of this string
+             * @param start Position of the first character to copy
+             * @param stop Position after the last character to copy, an invalid position copies until the end
+             * @return New string containing characters copied
+             */
+            BasicUString subStr(Position start, Position stop=Position(npos)) const;
+
+            /*! Get the position of the character at a index
+             * @param idx Index of the character
+             * @return Position of the character, or the end of the string if idx is past the end
+             */
+            Position position(std::size_t idx) const;
+            /*! Get the index of the character at a position
+             * @param pos Position of the character
+             * @return Index of the character
+             */
+            std::size_t index(Position pos) const;
+            /*! Count the characters and build the whole character index now instead of on first use
+             *
+             * The const methods fill these caches on first use, several threads may do so at once. Calling this
+             * only moves the work out of the first lookup.
+             */
+            void buildIndex() const;
 
             /*! Find a UChar character
              * @param ch character to find
@@ -386,7 +533,7 @@
              * @param start Position to begin searching from
              * @return Position of the first character of the string if found, npos if not.
              */
-            std::size_t find(const UString& what, std::size_t start=0) const;
+            std::size_t find(UStringView what, std::size_t start=0) const;
             /*! Find the last instance of a UChar character
              * @param ch Character to search for
              * @param pos Position of last character to include in search
@@ -395,11 +542,53 @@
             std::size_t findLastOf(UChar ch, std::size_t pos=npos) const;
 
             /*! Find the last instance of a string
-             * @param what String to search for
+             * @param what String to search for, an empty string is never found
              * @param pos Position of last character to include in search
-             * @return Position of the character of the string if found, npos if not.
+             * @return Position of the last character of the string if found, npos if not.
+             */
+            std::size_t findLastOf(UStringView what, std::size_t pos=npos) const;
+
+            /*! Find a UChar character
+             * @param ch Character to find
+             * @param start Position to begin searching from
+             * @return Position of the character if found, an invalid position if not.
+             */
+            Position find(UChar ch, Position start) const;
+            /*! Find a string
+             * @param what String to search for
+             * @param start Position to begin searching from
+             * @return Position of the first character of the string if found, an invalid position if not.
+             */
+            Position find(UStringView what, Position start) const;
+            /*! Find the last instance of a UChar character
+             * @param ch Character to search for
+             * @param stop Only characters before this position are searched, an invalid position searches the whole string
+             * @return Position of the character if found, an invalid position if not.
+             */
+            Position findLastOf(UChar ch, Position stop) const;
+            /*! Find the last instance of a string
+             * @param what String to search for
+             * @param stop Only matches ending before this position are searched, an invalid position searches the whole string
+             * @return Position of the first character of the string if found, an invalid position if not.
              */
-            std::size_t findLastOf(const UString& what, std::size_t pos=npos) const;
+            Position findLastOf(UStringView what, Position stop) const;
+
+            /*! Split the string at every occurrence of a delimiter, see UStringView::split()
+             *
+             * The fields point into this string, so splitting a temporary string is not allowed.
+             * @param delim Delimiter between the fields
+             * @return Range of views of the fields, valid until the string is modified
+             */
+            UStringSplitRange split(UStringView delim) const & { return UStringView(*this).split(delim); }
+            UStringSplitRange split(UStringView delim) const && = delete;
+            /*! Split the string at every character contained in a set, see UStringView::splitAny()
+             * @param delims Set of delimiter characters, the range keeps a copy
+             * @return Range of views of the fields, valid until the string is modified
+             */
+            UStringSplitRange splitAny(const UCharSet& delims) const & { return UStringView(*this).splitAny(delims); }
+            UStringSplitRange splitAny(UCharSet&& delims) const & { return UStringView(*this).splitAny(std::move(delims)); }
+            UStringSplitRange splitAny(const UCharSet& delims) const && = delete;
+            UStringSplitRange splitAny(UCharSet&& delims) const && = delete;
 
             /*! Replace part of this string with another string
              * @param start Start of the section to replace
@@ -407,47 +596,60 @@
              * @param with String to replace cut subsection with
              * @return Reference to this object
              */
-            UString& replace(std::size_t start, std::size_t len, const UString& with);
+            BasicUString& replace(std::size_t start, std::size_t len, const BasicUString& with);
+            /*! Replace part of this string with another string
+             * @param start Position of the first character to replace
+             * @param stop Position after the last character to replace
+             * @param with String to replace cut subsection with
+             * @return Reference to this object
+             */
+            BasicUString& replace(Position start, Position stop, const BasicUString& with);
             /*! Replace all instances of a string with another
              * @param what String to search for
              * @param with String to use for replacement
              * @param start The position to begin searching at
              * @return Reference to this object
              */
-            UString& replaceAll(const UString& what, const UString& with, std::size_t start=0);
+            BasicUString& replaceAll(const BasicUString& what, const BasicUString& with, std::size_t start=0);
             /*! Replace first instance of a string with another
              * @param what String to search for
              * @param with String to use for replacement
              * @param start The position to begin searching at
              * @return Reference to this object
              */
-            UString& replaceFirst(const UString& what, const UString& with, std::size_t start=0);
+            BasicUString& replaceFirst(const BasicUString& what, const BasicUString& with, std::size_t start=0);
             /*! Replace last instance of a string with another
              * @param what String to search for
              * @param with String to use for replacement
              * @param end The position to end our search at or npos
              * @return Reference to this object
              */
-            UString& replaceLast(const UString& what, const UString& with, std::size_t end=npos);
+            BasicUString& replaceLast(const BasicUString& what, const BasicUString& with, std::size_t end=npos);
 
             /*! Erase character(s) at given index
              * @param start Iterator reference to position to begin erasing
              * @param stop Iterator reference to position to stop erasing
              * @return Reference to this object
              */
-            UString& erase(const Iterator& start, const Iterator& stop);
+            BasicUString& erase(const Iterator& start, const Iterator& stop);
 
             /*! Clear this string
              * @return Reference to this object
              */
-            UString& clear();
+            BasicUString& clear();
 
             /*! Erase character(s) in given iterator range
              * @param start Index of character to start erasing
              * @param num Number of characters to erase
              * @return Reference to this object
              */
-            UString& erase(std::size_t start, std::size_t num=1);
+            BasicUString& erase(std::size_t start, std::size_t num=1);
+            /*! Erase the characters between two positions
+             * @param start Position of the first character to erase
+             * @param stop Position after the last character to erase
+             * @return Reference to this object
+             */
+            BasicUString& erase(Position start, Position stop);
 
             /*! Returns a iterator pointing to the beginning of the string
              * @return Iterator pointing to the start of the string
@@ -488,6 +690,13 @@
             using reverse_iterator          = ReverseIterator;
             using const_reverse_iterator    = ConstReverseIterator;
 
+            /*! Get the allocator used for the bytes of the string
+             *
+             * This is provided for STL compatibility
+             * @return Copy of the allocator
+             */
+            allocator_type get_allocator() const { return mData.get_allocator(); }
+
             /*! Returns the length of characters in the string
              * @return The length of characters in the string starting from zero
              */
@@ -505,10 +714,143 @@
              */
             std::size_t maxSize() const;
         private:
-            std::string mData;
+            typedef typename std::allocator_traits<Allocator>::template rebind_alloc<std::size_t> IndexAllocator;
+            typedef std::vector<std::size_t, IndexAllocator> IndexType;
+            //! The index object itself is allocated with the string's allocator as well
+            typedef typename std::allocator_traits<Allocator>::template rebind_alloc<IndexType> IndexObjectAllocator;
+            typedef std::allocator_traits<IndexObjectAllocator> IndexObjectTraits;
+
+            /*! Add the length of str to the cached length of this string after appending or prepending it
+             */
+            void addLength(const BasicUString& str);
+            /*! Update the cached length after mData was changed without counting the code-points
+             *
+             * Short strings are counted right away, longer strings are counted by the next call to length()
+             */
+            void recountLength();
+            /*! Drop the sparse byte index after characters before the end of the string changed
+             */
+            void clearIndex() { destroyIndex(mIndex.exchange(nullptr, std::memory_order_relaxed)); }
+            /*! Add entries for the characters appended after the index was built
+             */
+            void extendIndex();
+            /*! Get the sparse byte index, building and publishing it if no thread did so yet
+             */
+            const IndexType& sharedIndex() const;
+            /*! Add an entry for every IndexStride'th code-point after the last entry of index
+             */
+            void fillIndex(IndexType& index) const;
+            /*! Allocate an index holding the first entry, with the string's allocator
+             */
+            IndexType* createIndex() const;
+            /*! Free an index created by createIndex(), it may be nullptr
+             */
+            void destroyIndex(IndexType* index) const;
+            /*! Get the cached length, npos if the code-points were not counted yet
+             */
+            std::size_t cachedLength() const { return mLength.load(std::memory_order_relaxed); }
+            void setLength(std::size_t length) { mLength.store(length, std::memory_order_relaxed); }
+            /*! Check if the string only contains ASCII, character positions are byte offsets in that case
+             */
+            bool isAscii() const { return( length() == mData.size() ); }
+            /*! Get the character position ending a range of len characters starting at pos, clamped to the length
+             */
+            std::size_t endPosition(std::size_t pos, std::size_t len) const;
+            /*! Get the byte offset of the character at pos, or the size of the string if pos is past the end
+             */
+            std::size_t byteOffset(std::size_t pos) const;
+            /*! Replace every character with the result of map, used by the case conversions
+             */
+            BasicUString& mapCharacters(UChar (*map)(UChar::ValueType));
+
+            /*! Get the byte offset of a position, invalid positions are treated as the end of the string
+             */
+            static std::size_t clampedOffset(Position pos, const StringType& data);
+
+            //! Strings longer than this get a sparse index holding the byte offset of every IndexStride'th code-point
+            static const std::size_t IndexStride = 64;
+            //! Strings up to this many bytes are counted as soon as their bytes are set, so length() never scans them
+            static const std::size_t EagerCountSize = 32;
+
+            // The bytes are kept in StringType, so short strings rely on its own small-string buffer (15 bytes with
+            // libstdc++, 22 with libc++). There is no UTF-8 specific inline layout holding the bytes, length and
+            // ASCII flag together: toStdString(), adopt() and release() expose StringType itself.
+            //
+            // Const methods count the length and build the index on first use. Both are atomic so several threads
+            // may do that at once, an index is never changed or freed by a const method once it is published.
+            StringType                          mData;
+            mutable std::atomic<std::size_t>    mLength{0};     //!< Number of code-points in mData, npos if they need to be counted
+
+            //! Byte offsets of every 64th code-point, only allocated once a long string is indexed
+            mutable std::atomic<IndexType*>     mIndex{nullptr};
+
+        public:
+            /*! Write the string to a stream
+             * @return Reference to os
+             */
+            friend std::ostream& operator<<(std::ostream& os, const BasicUString& str)
+            {
+                os << str.mData;
+                return os;
+            }
+            /*! Compare two strings byte by byte
+             * @return True if str1 sorts before str2
+             */
+            friend bool operator<(const BasicUString& str1, const BasicUString& str2)
+            {
+                return( str1.mData < str2.mData );
+            }
+
+            /*! Concatenate two strings, the result uses the allocator of str1
+             * @return New string containing str1 followed by str2
+             */
+            friend BasicUString operator+(const BasicUString& str1, const BasicUString& str2)
+            {
+                BasicUString retStr(str1, str1.get_allocator());
+                retStr.append(str2);
+                return retStr;
+            }
+            /*! Concatenate two strings, reusing the buffer of str1
+             * @return New string containing str1 followed by str2
+             */
+            friend BasicUString operator+(BasicUString&& str1, const BasicUString& str2)
+            {
+                return std::move(str1.append(str2));
+            }
+            /*! Concatenate two strings, reusing the buffer of str2
+             * @return New string containing str1 followed by str2
+             */
+            friend BasicUString operator+(const BasicUString& str1, BasicUString&& str2)
+            {
+                return std::move(str2.prepend(str1));
+            }
+            /*! Concatenate two strings, reusing the buffer of str1
+             * @return New string containing str1 followed by str2
+             */
+            friend BasicUString operator+(BasicUString&& str1, BasicUString&& str2)
+            {
+                return std::move(str1.append(str2));
+            }
     };
 
-	std::ostream& operator<<(std::ostream& os, const UString& str);
-    bool operator<(const UString& str1, const UString &str2);
+    //! UTF-8 string using std::allocator, this is the string type used throughout the library
+    typedef BasicUString<std::allocator<char>> UString;
+
+    #if __cplusplus >= 201703L && defined(__has_include)
+        #if __has_include(<memory_resource>)
+            #include <memory_resource>
+
+            namespace pmr
+            {
+                //! UTF-8 string allocating from a std::pmr::memory_resource
+                typedef BasicUString<std::pmr::polymorphic_allocator<char>> UString;
+            }
+        #endif
+    #endif
+
+    #include "UStringImpl.h"
+
+    // The std::allocator instantiation is compiled into the library
+    extern template class BasicUString<std::allocator<char>>;
 
 #endif
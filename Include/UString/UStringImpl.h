@@ -0,0 +1,1010 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _USTRING_USTRINGIMPL_H_
+#define _USTRING_USTRINGIMPL_H_
+
+    // Member definitions of BasicUString, included at the end of UString.h
+
+    #include <algorithm>
+    #include <cassert>
+    #include <iterator>
+    #include <utility>
+
+    /*! Buffer used while the bytes of a BasicUString are rebuilt
+     *
+     * The new bytes are built in a local string using the allocator of the string being changed, and swapped in.
+     */
+    template<typename Allocator>
+    class UStringScratch
+    {
+        public:
+            typedef typename BasicUString<Allocator>::StringType StringType;
+
+            explicit UStringScratch(const Allocator& alloc) : mBytes(alloc) { }
+
+            StringType& bytes() { return mBytes; }
+            void moveTo(StringType& target) { target.swap(mBytes); }
+        private:
+            StringType mBytes;
+    };
+
+    /*! Buffer used while the bytes of a UString are rebuilt
+     *
+     * Every thread reuses one std::string, and the result is copied into the capacity the target already has, so
+     * repeated edits of similar sized strings don't allocate.
+     *
+     * The class is not reentrant: at most one UStringScratch<std::allocator<char>> may be alive per thread, so a
+     * member function must not call another member that rebuilds the bytes while its own scratch is alive. Debug
+     * builds assert on a second live scratch.
+     */
+    template<>
+    class UStringScratch<std::allocator<char>>
+    {
+        public:
+            explicit UStringScratch(const std::allocator<char>&) : mBytes(buffer())
+            {
+                #ifndef NDEBUG
+                    assert(!inUse() && "only one UStringScratch can be alive per thread");
+                    inUse() = true;
+                #endif
+                mBytes.clear();
+            }
+            ~UStringScratch()
+            {
+                // Don't keep the memory of a single huge edit for the lifetime of the thread
+                if( mBytes.capacity() > MaxCapacity )
+                    std::string().swap(mBytes);
+                #ifndef NDEBUG
+                    inUse() = false;
+                #endif
+            }
+
+            std::string& bytes() { return mBytes; }
+            void moveTo(std::string& target) { target.assign(mBytes); }
+        private:
+            static std::string& buffer()
+            {
+                static thread_local std::string bytes;
+                return bytes;
+            }
+
+            #ifndef NDEBUG
+                static bool& inUse()
+                {
+                    static thread_local bool used = false;
+                    return used;
+                }
+            #endif
+
+            static const std::size_t MaxCapacity = 1024 * 1024;
+            std::string& mBytes;
+    };
+
+    template<typename Allocator>
+    const std::size_t BasicUString<Allocator>::npos;
+
+    template<typename Allocator>
+    const std::size_t BasicUString<Allocator>::IndexStride;
+
+    template<typename Allocator>
+    const std::size_t BasicUString<Allocator>::EagerCountSize;
+
+    template<typename Allocator>
+    std::size_t BasicUString<Allocator>::clampedOffset(Position pos, const StringType& data)
+    {
+        return std::min(pos.byteOffset(), data.size());
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>::BasicUString(UChar ch, const Allocator& alloc) USTRING_NOEXCEPT
+        : mData(alloc)
+    {
+        append(ch);
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>::BasicUString(const char *str, const Allocator& alloc) USTRING_NOEXCEPT
+        : mData(alloc)
+    {
+        if( str != nullptr )
+        {
+            mData.assign(str);
+            recountLength();
+        }
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>::BasicUString(UStringView view, const Allocator& alloc)
+        : mData(view.data(), view.size(), alloc)
+    {
+        // Views of _us literals and of other strings already know their length
+        if( view.mLength != npos )
+            setLength(view.mLength);
+        else
+            recountLength();
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>::BasicUString(const BasicUString& str) USTRING_NOEXCEPT
+        : mData(str.mData), mLength(str.cachedLength())
+    {
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>::BasicUString(const BasicUString& str, const Allocator& alloc) USTRING_NOEXCEPT
+        : mData(str.mData, alloc), mLength(str.cachedLength())
+    {
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>::BasicUString(BasicUString&& str) USTRING_NOEXCEPT
+        : mData(std::move(str.mData)), mLength(str.cachedLength()), mIndex(str.mIndex.exchange(nullptr, std::memory_order_relaxed))
+    {
+        str.recountLength();
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>::BasicUString(BasicUString&& str, const Allocator& alloc) USTRING_NOEXCEPT
+        : mData(std::move(str.mData), alloc), mLength(str.cachedLength())
+    {
+        // The index can only be taken over if this string's allocator can free it
+        if( mData.get_allocator() == str.mData.get_allocator() )
+            mIndex.store(str.mIndex.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+        else
+            str.clearIndex();
+        str.recountLength();
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>::~BasicUString()
+    {
+        clearIndex();
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>::BasicUString(const StringType& str) USTRING_NOEXCEPT
+        : mData(str)
+    {
+        recountLength();
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>::BasicUString(StringType&& str) USTRING_NOEXCEPT
+        : mData(std::move(str))
+    {
+        recountLength();
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::insert(const BasicUString& what, std::size_t where)
+    {
+        if( where == 0 )
+        {
+            prepend(what);
+            return *this;
+        }
+        else if( where > length()-1 )
+        {
+            append(what);
+            return *this;
+        }
+
+        mData.insert(byteOffset(where), what.mData);
+        addLength(what);
+        clearIndex();
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::insert(const BasicUString& what, Position where)
+    {
+        mData.insert(clampedOffset(where, mData), what.mData);
+        addLength(what);
+        clearIndex();
+        return *this;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////
+    /// Assignment                                                                        ///
+    /////////////////////////////////////////////////////////////////////////////////////////
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::assign(const BasicUString& str)
+    {
+        mData.assign(str.mData);
+        setLength(str.cachedLength());
+        clearIndex();
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::assign(const char* str)
+    {
+        if( str != nullptr )
+        {
+            mData.assign(str);
+            recountLength();
+            clearIndex();
+        }
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::assign(BasicUString&& str) USTRING_NOEXCEPT
+    {
+        clearIndex();
+        mData = std::move(str.mData);
+        setLength(str.cachedLength());
+
+        // The index can only be taken over if this string's allocator can free it
+        if( mData.get_allocator() == str.mData.get_allocator() )
+            mIndex.store(str.mIndex.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+        else
+            str.clearIndex();
+        str.recountLength();
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::operator=(const BasicUString& str)
+    {
+        return assign(str);
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::operator=(BasicUString&& str) USTRING_NOEXCEPT
+    {
+        return assign(std::move(str));
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::operator=(const char* str)
+    {
+        return assign(str);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////
+    /// Append/Prepend                                                                    ///
+    /////////////////////////////////////////////////////////////////////////////////////////
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::append(UChar ch)
+    {
+        utf8::append(ch, std::back_inserter(mData));
+        if( cachedLength() != npos )
+            setLength(cachedLength() + 1);
+        extendIndex();
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::append(const char* str)
+    {
+        if( str != nullptr )
+        {
+            mData.append(str);
+            recountLength();
+            extendIndex();
+        }
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::append(const BasicUString& str)
+    {
+        mData.append(str.mData);
+        addLength(str);
+        extendIndex();
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::append(BasicUString&& str)
+    {
+        if( mData.empty() )
+            return assign(std::move(str));
+
+        mData.append(str.mData);
+        addLength(str);
+        extendIndex();
+        return *this;
+    }
+
+    template<typename Allocator>
+    void BasicUString<Allocator>::push_back(UChar ch)
+    {
+        append(ch);
+    }
+
+    template<typename Allocator>
+    void BasicUString<Allocator>::push_back(const BasicUString& str)
+    {
+        append(str);
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::prepend(UChar ch)
+    {
+        mData.insert(0, BasicUString(ch, get_allocator()).mData);
+        if( cachedLength() != npos )
+            setLength(cachedLength() + 1);
+        clearIndex();
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::prepend(const char *str)
+    {
+        if( str != nullptr )
+        {
+            mData.insert(0, str);
+            recountLength();
+            clearIndex();
+        }
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::prepend(const BasicUString& str)
+    {
+        mData.insert(0, str.mData);
+        addLength(str);
+        clearIndex();
+        return *this;
+    }
+
+    template<typename Allocator>
+    void BasicUString<Allocator>::push_front(UChar ch)
+    {
+        prepend(ch);
+    }
+
+    template<typename Allocator>
+    void BasicUString<Allocator>::push_front(const BasicUString& str)
+    {
+        prepend(str);
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::operator+=(const BasicUString& str)
+    {
+        append(str);
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::operator+=(const char* str)
+    {
+        append(str);
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::operator+=(BasicUString&& str)
+    {
+        return append(std::move(str));
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////
+    /// Comparison                                                                        ///
+    /////////////////////////////////////////////////////////////////////////////////////////
+    template<typename Allocator>
+    bool BasicUString<Allocator>::operator==(const BasicUString& str) const
+    {
+        return( mData == str.mData );
+    }
+
+    template<typename Allocator>
+    bool BasicUString<Allocator>::operator==(const char* str) const
+    {
+        return( str && mData == str );
+    }
+
+    template<typename Allocator>
+    bool BasicUString<Allocator>::operator!=(const BasicUString& str) const
+    {
+        return( mData != str.mData );
+    }
+
+    template<typename Allocator>
+    bool BasicUString<Allocator>::operator!=(const char* str) const
+    {
+        return( str && mData != str );
+    }
+
+    template<typename Allocator>
+    int BasicUString<Allocator>::compare(const BasicUString& other) const
+    {
+        return mData.compare(other.mData);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////
+    /// Case Conversion                                                                   ///
+    /////////////////////////////////////////////////////////////////////////////////////////
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::toLower()
+    {
+        return mapCharacters(&UChar::toLower);
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::toUpper()
+    {
+        return mapCharacters(&UChar::toUpper);
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::toTitleCase()
+    {
+        return mapCharacters(&UChar::toTitleCase);
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::mapCharacters(UChar (*map)(UChar::ValueType))
+    {
+        UStringScratch<Allocator> scratch(mData.get_allocator());
+        StringType& bytes = scratch.bytes();
+
+        std::size_t count = 0;
+        for( auto iter = mData.begin(); iter != mData.end(); count++ )
+            utf8::append(map(utf8::next(iter, mData.end())), std::back_inserter(bytes));
+
+        scratch.moveTo(mData);
+        setLength(count);
+        clearIndex();
+        return *this;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////
+    /// Type-Casting                                                                      ///
+    /////////////////////////////////////////////////////////////////////////////////////////
+    template<typename Allocator>
+    const typename BasicUString<Allocator>::StringType& BasicUString<Allocator>::toStdString() const
+    {
+        return mData;
+    }
+
+    template<typename Allocator>
+    typename BasicUString<Allocator>::StringType BasicUString<Allocator>::release() &&
+    {
+        StringType bytes(std::move(mData));
+        clear();
+        return bytes;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator> BasicUString<Allocator>::adopt(StringType&& str, bool validate)
+    {
+        if( validate )
+        {
+            auto invalid = utf8::find_invalid(str.begin(), str.end());
+            if( invalid != str.end() )
+                throw utf8::invalid_utf8(static_cast<std::uint8_t>(*invalid));
+        }
+        return BasicUString(std::move(str));
+    }
+
+    template<typename Allocator>
+    const std::u16string BasicUString<Allocator>::toStdU16String() const
+    {
+        std::u16string u16str;
+        utf8::utf8to16(mData.begin(), mData.end(), std::back_inserter(u16str));
+        return u16str;
+    }
+
+    template<typename Allocator>
+    const std::u32string BasicUString<Allocator>::toStdU32String() const
+    {
+        std::u32string u32str;
+        utf8::utf8to32(mData.begin(), mData.end(), std::back_inserter(u32str));
+        return u32str;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator> BasicUString<Allocator>::fromStdU16String(const std::u16string& str, const Allocator& alloc)
+    {
+        BasicUString retStr(alloc);
+        utf8::utf16to8(str.begin(), str.end(), std::back_inserter(retStr.mData));
+        retStr.recountLength();
+        return retStr;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator> BasicUString<Allocator>::fromStdU32String(const std::u32string& str, const Allocator& alloc)
+    {
+        BasicUString retStr(alloc);
+        utf8::utf32to8(str.begin(), str.end(), std::back_inserter(retStr.mData));
+        retStr.setLength(str.size());
+        return retStr;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////
+    /// Size                                                                              ///
+    /////////////////////////////////////////////////////////////////////////////////////////
+    template<typename Allocator>
+    std::size_t BasicUString<Allocator>::length() const
+    {
+        // Threads counting at the same time store the same value
+        std::size_t length = cachedLength();
+        if( length == npos )
+        {
+            length = UStringView::countCodePoints(mData.data(), mData.size());
+            mLength.store(length, std::memory_order_relaxed);
+        }
+        return length;
+    }
+
+    template<typename Allocator>
+    std::size_t BasicUString<Allocator>::endPosition(std::size_t pos, std::size_t len) const
+    {
+        std::size_t start = std::min(pos, length());
+        return( len >= length() - start ? length() : start + len );
+    }
+
+    template<typename Allocator>
+    std::size_t BasicUString<Allocator>::byteOffset(std::size_t pos) const
+    {
+        if( pos >= length() )
+            return mData.size();
+        if( isAscii() )
+            return pos;
+
+        auto        iter = mData.begin();
+        std::size_t walk = pos;
+
+        // Long strings start from the index entry before pos and only walk the rest
+        if( length() > IndexStride )
+        {
+            iter += sharedIndex()[pos / IndexStride];
+            walk  = pos % IndexStride;
+        }
+
+        utf8::advance(iter, walk, mData.end());
+        return( iter - mData.begin() );
+    }
+
+    template<typename Allocator>
+    const typename BasicUString<Allocator>::IndexType& BasicUString<Allocator>::sharedIndex() const
+    {
+        IndexType* index = mIndex.load(std::memory_order_acquire);
+        if( index == nullptr )
+        {
+            // The whole string is indexed at once, so a published index is never written to by a const method
+            IndexType* built = createIndex();
+            fillIndex(*built);
+
+            if( mIndex.compare_exchange_strong(index, built, std::memory_order_acq_rel, std::memory_order_acquire) )
+                index = built;
+            else
+                destroyIndex(built);    // Another thread published its index first, index now points to it
+        }
+        return *index;
+    }
+
+    template<typename Allocator>
+    void BasicUString<Allocator>::fillIndex(IndexType& index) const
+    {
+        std::size_t count = 0;
+        for( std::size_t i = index.back(); i < mData.size(); i++ )
+        {
+            if( (static_cast<unsigned char>(mData[i]) & 0xC0) != 0x80 )
+            {
+                if( count == IndexStride )
+                {
+                    index.push_back(i);
+                    count = 0;
+                }
+                count++;
+            }
+        }
+    }
+
+    template<typename Allocator>
+    void BasicUString<Allocator>::extendIndex()
+    {
+        // Nothing to add until the string reaches the character after the last entry's stride
+        IndexType*  index  = mIndex.load(std::memory_order_relaxed);
+        std::size_t length = cachedLength();
+        if( index != nullptr && (length == npos || length > index->size() * IndexStride) )
+            fillIndex(*index);
+    }
+
+    template<typename Allocator>
+    typename BasicUString<Allocator>::IndexType* BasicUString<Allocator>::createIndex() const
+    {
+        IndexObjectAllocator alloc(mData.get_allocator());
+        IndexType* index = IndexObjectTraits::allocate(alloc, 1);
+        try
+        {
+            // Not IndexObjectTraits::construct(), a polymorphic_allocator would pass itself as another argument
+            ::new(static_cast<void*>(index)) IndexType(1, 0, IndexAllocator(mData.get_allocator()));
+        }
+        catch( ... )
+        {
+            IndexObjectTraits::deallocate(alloc, index, 1);
+            throw;
+        }
+        return index;
+    }
+
+    template<typename Allocator>
+    void BasicUString<Allocator>::destroyIndex(IndexType* index) const
+    {
+        if( index != nullptr )
+        {
+            IndexObjectAllocator alloc(mData.get_allocator());
+            index->~IndexType();
+            IndexObjectTraits::deallocate(alloc, index, 1);
+        }
+    }
+
+    template<typename Allocator>
+    void BasicUString<Allocator>::addLength(const BasicUString& str)
+    {
+        std::size_t length = str.cachedLength();
+        if( cachedLength() != npos && length != npos )
+            setLength(cachedLength() + length);
+        else
+            recountLength();
+    }
+
+    template<typename Allocator>
+    void BasicUString<Allocator>::recountLength()
+    {
+        setLength( mData.size() <= EagerCountSize ? UStringView::countCodePoints(mData.data(), mData.size()) : npos );
+    }
+
+    template<typename Allocator>
+    std::size_t BasicUString<Allocator>::size() const
+    {
+        return mData.size();
+    }
+
+    template<typename Allocator>
+    std::size_t BasicUString<Allocator>::maxSize() const
+    {
+        return mData.max_size();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////
+    /// Character Indexing                                                                ///
+    /////////////////////////////////////////////////////////////////////////////////////////
+    template<typename Allocator>
+    const UChar BasicUString<Allocator>::at(std::size_t i) const
+    {
+        if( i >= length() )
+            return UCHAR_CODE_NULL;
+        if( isAscii() )
+            return UChar(static_cast<unsigned char>(mData[i]));
+
+        return utf8::peek_next(mData.begin() + byteOffset(i), mData.end());
+    }
+
+    template<typename Allocator>
+    const UChar BasicUString<Allocator>::operator[](std::size_t i) const
+    {
+        return at(i);
+    }
+
+    template<typename Allocator>
+    typename BasicUString<Allocator>::Position BasicUString<Allocator>::position(std::size_t i) const
+    {
+        return Position(byteOffset(i));
+    }
+
+    template<typename Allocator>
+    std::size_t BasicUString<Allocator>::index(Position pos) const
+    {
+        std::size_t offset = clampedOffset(pos, mData);
+        if( isAscii() )
+            return offset;
+
+        // Count from the closest index entry before the position if the index was built
+        std::size_t startOffset = 0;
+        std::size_t startIndex  = 0;
+        if( const IndexType* index = mIndex.load(std::memory_order_acquire) )
+        {
+            auto entry = std::upper_bound(index->begin(), index->end(), offset);
+            if( entry != index->begin() )
+            {
+                --entry;
+                startOffset = *entry;
+                startIndex  = (entry - index->begin()) * IndexStride;
+            }
+        }
+
+        return startIndex + UStringView::countCodePoints(mData.data() + startOffset, offset - startOffset);
+    }
+
+    template<typename Allocator>
+    void BasicUString<Allocator>::buildIndex() const
+    {
+        if( !isAscii() && length() > IndexStride )
+            sharedIndex();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////
+    /// Sub-String                                                                        ///
+    /////////////////////////////////////////////////////////////////////////////////////////
+    template<typename Allocator>
+    BasicUString<Allocator> BasicUString<Allocator>::subStr(std::size_t start, std::size_t len) const
+    {
+        std::size_t startByte = byteOffset(start);
+        std::size_t endByte   = byteOffset(endPosition(start, len));
+
+        BasicUString retStr(StringType(mData, startByte, endByte - startByte, mData.get_allocator()));
+        retStr.setLength(endPosition(start, len) - std::min(start, length()));
+        return retStr;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator> BasicUString<Allocator>::subStr(Position start, Position stop) const
+    {
+        std::size_t startByte = clampedOffset(start, mData);
+        std::size_t stopByte  = std::max(startByte, clampedOffset(stop, mData));
+
+        return BasicUString(StringType(mData, startByte, stopByte - startByte, mData.get_allocator()));
+    }
+
+    template<typename Allocator>
+    std::size_t BasicUString<Allocator>::find(UChar ch, std::size_t pos) const
+    {
+        if( isAscii() )
+            return( ch < 0x80 ? mData.find(static_cast<char>(ch), pos) : npos );
+        if( pos != npos && pos > length() )
+            return npos;
+
+        auto startIter = begin();
+        if( pos != npos )
+            std::advance(startIter, pos);
+
+        auto iter = std::find(startIter, end(), ch);
+        if( iter != end() )
+            return std::distance(begin(), iter);
+
+        return npos;
+    }
+
+    template<typename Allocator>
+    std::size_t BasicUString<Allocator>::find(UStringView find, std::size_t start) const
+    {
+        // A non-ASCII string can never be found, std::string::find returns npos for it
+        if( isAscii() )
+            return mData.find(find.data(), start, find.size());
+        if( start != npos && start > length() )
+            return npos;
+
+        auto startIter = begin();
+        if( start != npos )
+            std::advance(startIter, start);
+
+        auto iter = std::search(startIter, end(), find.begin(), find.end());
+        if( iter != end() )
+            return std::distance(begin(), iter);
+
+        return npos;
+    }
+
+    template<typename Allocator>
+    std::size_t BasicUString<Allocator>::findLastOf(UChar ch, std::size_t pos) const
+    {
+        // pos counts the characters skipped from the end of the string
+        if( isAscii() )
+        {
+            if( ch >= 0x80 || (pos != npos && pos >= mData.size()) )
+                return npos;
+            return mData.rfind(static_cast<char>(ch), pos == npos ? npos : mData.size() - pos - 1);
+        }
+        if( pos != npos && pos >= length() )
+            return npos;
+
+        auto startIter = rbegin();
+        if( pos != npos )
+            std::advance(startIter, pos);
+
+        auto iter = std::find(startIter, rend(), ch);
+        if( iter != rend() )
+            return length() - std::distance(rbegin(), iter) - 1;
+
+        return npos;
+    }
+
+    template<typename Allocator>
+    typename BasicUString<Allocator>::Position BasicUString<Allocator>::find(UChar ch, Position start) const
+    {
+        char bytes[4];
+        return find(UStringView(bytes, utf8::append(ch, bytes) - bytes, 1), start);
+    }
+
+    template<typename Allocator>
+    typename BasicUString<Allocator>::Position BasicUString<Allocator>::find(UStringView what, Position start) const
+    {
+        // UTF-8 is self-synchronizing, so a byte match always starts on a character boundary
+        return Position(mData.find(what.data(), clampedOffset(start, mData), what.size()));
+    }
+
+    template<typename Allocator>
+    typename BasicUString<Allocator>::Position BasicUString<Allocator>::findLastOf(UChar ch, Position stop) const
+    {
+        char bytes[4];
+        return findLastOf(UStringView(bytes, utf8::append(ch, bytes) - bytes, 1), stop);
+    }
+
+    template<typename Allocator>
+    typename BasicUString<Allocator>::Position BasicUString<Allocator>::findLastOf(UStringView what, Position stop) const
+    {
+        std::size_t stopByte = clampedOffset(stop, mData);
+        if( what.size() > stopByte )
+            return Position(npos);
+
+        return Position(mData.rfind(what.data(), stopByte - what.size(), what.size()));
+    }
+
+    template<typename Allocator>
+    std::size_t BasicUString<Allocator>::findLastOf(UStringView find, std::size_t pos) const
+    {
+        // Returns the position of the last character of the match, pos counts the characters skipped from the end.
+        // An empty string has no last character and is never found.
+        if( find.size() == 0 )
+            return npos;
+        if( isAscii() )
+        {
+            if( pos != npos && pos + find.size() > mData.size() )
+                return npos;
+
+            std::size_t found = mData.rfind(find.data(), pos == npos ? npos : mData.size() - pos - find.size(), find.size());
+            return( found != npos ? found + find.size() - 1 : npos );
+        }
+        if( pos != npos && pos >= length() )
+            return npos;
+
+        auto startIter = rbegin();
+        if( pos != npos )
+            std::advance(startIter, pos);
+
+        auto iter = std::search(startIter, rend(), find.rbegin(), find.rend());
+        if( iter != rend() )
+            return length() - std::distance(rbegin(), iter) - 1;
+
+        return npos;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::replace(std::size_t start, std::size_t len, const BasicUString& with)
+    {
+        std::size_t startByte = byteOffset(start);
+        std::size_t endByte   = byteOffset(endPosition(start, len));
+        std::size_t removed   = endPosition(start, len) - std::min(start, length());
+
+        // with may be this string, so its length is read before the bytes change
+        std::size_t newLength = length() - removed + with.length();
+        mData.replace(startByte, endByte - startByte, with.mData);
+        setLength(newLength);
+        clearIndex();
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::replace(Position start, Position stop, const BasicUString& with)
+    {
+        std::size_t startByte = clampedOffset(start, mData);
+        std::size_t stopByte  = std::max(startByte, clampedOffset(stop, mData));
+
+        // with may be this string, so its length is read before the bytes change
+        std::size_t length = cachedLength();
+        std::size_t withLength = with.cachedLength();
+        if( length != npos && withLength != npos )
+            length = length - UStringView::countCodePoints(mData.data() + startByte, stopByte - startByte) + withLength;
+        else
+            length = npos;
+
+        mData.replace(startByte, stopByte - startByte, with.mData);
+        if( length != npos )
+            setLength(length);
+        else
+            recountLength();
+        clearIndex();
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::replaceAll(const BasicUString& what, const BasicUString& with, std::size_t start)
+    {
+        // An empty string would be found at every position
+        if( what.mData.empty() )
+            return *this;
+
+        // UTF-8 is self-synchronizing, so a byte match always starts on a character boundary
+        std::size_t found = mData.find(what.mData, byteOffset(start));
+        if( found == npos )
+            return *this;
+
+        UStringScratch<Allocator> scratch(mData.get_allocator());
+        StringType& bytes = scratch.bytes();
+
+        std::size_t copied = 0;
+        std::size_t count  = 0;
+        for( ; found != npos; found = mData.find(what.mData, copied), count++ )
+        {
+            bytes.append(mData, copied, found - copied);
+            bytes.append(with.mData);
+            copied = found + what.mData.size();
+        }
+        bytes.append(mData, copied, npos);
+
+        std::size_t newLength = length() - count * what.length() + count * with.length();
+        scratch.moveTo(mData);
+        setLength(newLength);
+        clearIndex();
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::replaceFirst(const BasicUString& what, const BasicUString& with, std::size_t start)
+    {
+        std::size_t pos = find(what, start);
+        if( pos != npos )
+            replace(pos, what.length(), with);
+
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::replaceLast(const BasicUString& what, const BasicUString& with, std::size_t end)
+    {
+        if( end != npos )
+            end = length() - end;
+
+        std::size_t pos = findLastOf(what, end);
+        if( pos != npos )
+            replace(pos-what.length()+1, what.length(), with);
+
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::clear()
+    {
+        mData.clear();
+        setLength(0);
+        clearIndex();
+        return *this;
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::erase(const Iterator& start, const Iterator& stop)
+    {
+        return erase(Position(start.base() - mData.begin()), Position(stop.base() - mData.begin()));
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::erase(std::size_t start, std::size_t num)
+    {
+        return replace(start, num, BasicUString(get_allocator()));
+    }
+
+    template<typename Allocator>
+    BasicUString<Allocator>& BasicUString<Allocator>::erase(Position start, Position stop)
+    {
+        return replace(start, stop, BasicUString(get_allocator()));
+    }
+
+#endif
@@ -0,0 +1,161 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef _USTRING_USTRINGPOOL_H_
+#define _USTRING_USTRINGPOOL_H_
+
+    #include "UString.h"
+    #include <functional>
+    #include <memory>
+    #include <mutex>
+    #include <ostream>
+    #include <unordered_set>
+    #include <vector>
+
+    /*! Handle to a string interned in a UStringPool
+     *
+     * An atom is the size of a pointer. Every atom of the same string from the same pool holds the same pointer, so
+     * comparing and hashing atoms are O(1) and never look at the characters. The default atom is the empty string,
+     * interning an empty string always returns it.
+     *
+     * An atom is valid as long as the pool it came from. Atoms of the same string from different pools are not equal.
+     */
+    class UAtom
+    {
+        public:
+            /*! Create the empty atom
+             */
+            UAtom() = default;
+
+            /*! Get the interned string
+             * @return View of the string, valid as long as the pool
+             */
+            UStringView view() const                    { return( mView ? *mView : UStringView() ); }
+            operator UStringView() const                { return view(); }
+            /*! Copy the interned string
+             * @return New UString holding the characters of the atom
+             */
+            UString toUString() const                   { return UString(view()); }
+
+            /*! Get the number of characters of the string
+             * @return Number of code-points, the length is counted when the string is interned
+             */
+            std::size_t length() const                  { return view().length(); }
+            /*! Get the number of bytes of the string
+             * @return Number of UTF-8 bytes
+             */
+            std::size_t size() const                    { return view().size(); }
+            bool        empty() const                   { return( mView == nullptr ); }
+
+            /*! Get a hash of the atom
+             * @return Hash of the identity of the atom, not of its characters
+             */
+            std::size_t hash() const                    { return std::hash<const UStringView*>()(mView); }
+
+            bool operator==(const UAtom& other) const   { return( mView == other.mView ); }
+            bool operator!=(const UAtom& other) const   { return( mView != other.mView ); }
+            /*! Order atoms by identity
+             *
+             * The order is not alphabetical, but it is fixed for the lifetime of the pool which makes atoms usable
+             * as keys of ordered containers.
+             */
+            bool operator<(const UAtom& other) const    { return std::less<const UStringView*>()(mView, other.mView); }
+
+        private:
+            friend class UStringPool;
+
+            explicit UAtom(const UStringView* view) : mView(view) { }
+
+            const UStringView* mView = nullptr;    //!< Entry in the pool, nullptr for the empty string
+    };
+
+    inline std::ostream& operator<<(std::ostream& os, UAtom atom)
+    {
+        return( os << atom.view() );
+    }
+
+    namespace std
+    {
+        template<>
+        struct hash<UAtom>
+        {
+            std::size_t operator()(const UAtom& atom) const { return atom.hash(); }
+        };
+    }
+
+    /*! Thread-safe table of unique strings
+     *
+     * intern() stores every distinct string once and returns a UAtom for it. The characters of the strings are
+     * packed into large blocks instead of a heap allocation per string, and nothing is removed until the pool is
+     * destroyed, so the atoms handed out stay valid for the lifetime of the pool.
+     *
+     * All methods may be called from several threads at once, reading the string of an atom takes no lock.
+     */
+    class UStringPool
+    {
+        public:
+            UStringPool() = default;
+
+            UStringPool(const UStringPool&) = delete;
+            UStringPool& operator=(const UStringPool&) = delete;
+
+            /*! Get the atom of a string, adding the string to the pool if it is not there yet
+             * @param str String to intern
+             * @return Atom of the string
+             */
+            UAtom intern(UStringView str);
+            /*! Get the atom of a string without adding it
+             * @param str String to look up
+             * @return Atom of the string, or the empty atom if the pool does not hold it
+             */
+            UAtom find(UStringView str) const;
+            /*! Check if the pool holds a string
+             * @param str String to look up
+             * @return True if str is empty or was interned
+             */
+            bool contains(UStringView str) const;
+
+            /*! Get the number of distinct strings in the pool
+             * @return Number of interned strings, not counting the empty string
+             */
+            std::size_t size() const;
+
+        private:
+            struct ViewHash
+            {
+                std::size_t operator()(const UStringView& str) const;
+            };
+
+            /*! Copy bytes into the blocks of the pool
+             * @return Pointer to the copy, followed by a null terminator
+             */
+            const char* store(const char* data, std::size_t size);
+
+            mutable std::mutex                          mMutex;
+            std::unordered_set<UStringView, ViewHash>   mEntries;           //!< Views into mBlocks, atoms point to them
+            std::vector<std::unique_ptr<char[]>>        mBlocks;
+            char*                                       mFree = nullptr;    //!< Unused bytes of the last block
+            std::size_t                                 mFreeSize = 0;
+    };
+
+#endif
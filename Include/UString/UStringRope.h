@@ -0,0 +1,212 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _USTRING_USTRINGROPE_H_
+#define _USTRING_USTRINGROPE_H_
+
+    #include "UString.h"
+    #include <cstdint>
+    #include <iterator>
+    #include <memory>
+
+    /*! UTF-8 string stored as a balanced tree of chunks, for editing large documents
+     *
+     * Every node of the tree holds a chunk of up to a few hundred bytes and caches the number of bytes and
+     * code-points below it. insert(), erase() and replace() split and join the tree at character indices in
+     * O(log n) and only touch the bytes of the chunks at the edit, instead of moving the rest of the string.
+     * The tree is a treap, a binary search tree ordered by character index that is kept balanced by giving
+     * every node a pseudo-random priority.
+     */
+    class UStringRope
+    {
+        private:
+            struct Node;
+            typedef std::unique_ptr<Node> NodePtr;
+
+        public:
+            typedef UChar value_type;
+
+            static const std::size_t npos = UString::npos;
+
+            /*! Bidirectional iterator over the characters of a rope
+             *
+             * Like the iterators of UString it is not writable. Any modification of the rope invalidates it.
+             */
+            class ConstIterator : public std::iterator<std::bidirectional_iterator_tag, UChar>
+            {
+                public:
+                    typedef UChar value_type;
+                    using reference = UChar;
+
+                    /*! Create a empty Iterator without a reference to any rope
+                     */
+                    ConstIterator() = default;
+
+                    ConstIterator& operator++();
+                    ConstIterator  operator++(int) { ConstIterator temp = *this; operator++(); return temp; }
+                    ConstIterator& operator--();
+                    ConstIterator  operator--(int) { ConstIterator temp = *this; operator--(); return temp; }
+                    const UChar    operator*() const;
+
+                    bool operator==(const ConstIterator& other) const { return( mNode == other.mNode && mOffset == other.mOffset ); }
+                    bool operator!=(const ConstIterator& other) const { return !operator==(other); }
+
+                private:
+                    friend class UStringRope;
+
+                    ConstIterator(const UStringRope* rope, const Node* node, std::size_t offset)
+                        : mRope(rope), mNode(node), mOffset(offset)
+                    {
+                    }
+
+                    const UStringRope*  mRope   = nullptr;
+                    const Node*         mNode   = nullptr;  //!< Node holding the character, nullptr at the end
+                    std::size_t         mOffset = 0;        //!< Byte offset of the character in the chunk of mNode
+            };
+
+            using Iterator          = ConstIterator;
+            // For STL compatibility
+            using iterator          = Iterator;
+            using const_iterator    = ConstIterator;
+
+            /*! Create an empty rope
+             */
+            UStringRope() USTRING_NOEXCEPT;
+            /*! Create a rope holding a copy of a string
+             * @param str String to copy
+             */
+            UStringRope(const UString& str);
+            /*! Create a rope holding a copy of a C-string
+             * @param cstr C-string to copy
+             */
+            UStringRope(const char* cstr);
+            UStringRope(const UStringRope& other);
+            UStringRope(UStringRope&& other) USTRING_NOEXCEPT;
+            ~UStringRope();
+
+            UStringRope& operator=(const UStringRope& other);
+            UStringRope& operator=(UStringRope&& other) USTRING_NOEXCEPT;
+
+            /*! Insert a string at a character index
+             *
+             * If the index is past the end of the rope the string is appended.
+             * @param what String to insert
+             * @param pos Index of the character to insert the string before
+             * @return Reference to this object
+             */
+            UStringRope& insert(const UString& what, std::size_t pos);
+            /*! Append a string to the end of the rope
+             * @param str String to append
+             * @return Reference to this object
+             */
+            UStringRope& append(const UString& str) { return insert(str, npos); }
+            /*! Prepend a string to the beginning of the rope
+             * @param str String to prepend
+             * @return Reference to this object
+             */
+            UStringRope& prepend(const UString& str) { return insert(str, 0); }
+            /*! Erase characters
+             * @param start Index of the first character to erase
+             * @param num Number of characters to erase
+             * @return Reference to this object
+             */
+            UStringRope& erase(std::size_t start, std::size_t num=1);
+            /*! Replace part of the rope with another string
+             * @param start Index of the first character to replace
+             * @param len Number of characters to replace
+             * @param with String to insert in their place
+             * @return Reference to this object
+             */
+            UStringRope& replace(std::size_t start, std::size_t len, const UString& with);
+            /*! Erase every character
+             * @return Reference to this object
+             */
+            UStringRope& clear();
+
+            /*! Copy a section of the rope into a new string
+             * @param start Index of the first character to copy
+             * @param len Number of characters to copy or until the end if len is npos
+             * @return New string containing the characters
+             */
+            UString subStr(std::size_t start, std::size_t len=npos) const;
+            /*! Copy the whole rope into a string
+             * @return New string containing every character of the rope
+             */
+            UString toUString() const;
+
+            /*! Get character at index idx
+             * @return Character, or UCHAR_CODE_NULL if idx is past the end
+             */
+            const UChar at(std::size_t idx) const;
+            /*! Get character at index idx
+             * @return Character, or UCHAR_CODE_NULL if idx is past the end
+             */
+            const UChar operator[](std::size_t idx) const { return at(idx); }
+
+            /*! Returns the number of characters in the rope
+             * @return The number of characters
+             */
+            std::size_t length() const;
+            /*! Returns the size of the rope in bytes
+             * @return The size of the rope in bytes
+             */
+            std::size_t size() const;
+
+            /*! Returns a iterator pointing to the first character
+             * @return Iterator pointing to the start of the rope
+             */
+            ConstIterator begin() const;
+            /*! Returns a iterator pointing past the last character
+             * @return Iterator pointing to the end of the rope
+             */
+            ConstIterator end() const { return ConstIterator(this, nullptr, 0); }
+
+        private:
+            /*! Split a tree after the first idx characters, a chunk holding the split point is cut in two
+             */
+            static void split(NodePtr node, std::size_t idx, NodePtr& left, NodePtr& right);
+            /*! Join two trees, every character of left comes before every character of right
+             */
+            static NodePtr merge(NodePtr left, NodePtr right);
+            /*! Recompute the cached counts of a node from its chunk and children
+             */
+            static void update(Node* node);
+            /*! Find the node holding the character at idx, and the index of the character in its chunk
+             *
+             * If inclusive is true an index at the end of a chunk returns that chunk instead of the next one.
+             */
+            Node* findNode(std::size_t& idx, bool inclusive) const;
+            /*! Add to the cached counts of a node and all of its parents after its chunk changed in place
+             */
+            static void adjustCounts(Node* node, std::ptrdiff_t length, std::ptrdiff_t size);
+            /*! Create a tree holding the bytes of str, cut into chunks on character boundaries
+             */
+            NodePtr build(const std::string& bytes);
+            /*! Create a single node with the next pseudo-random priority
+             */
+            NodePtr makeNode(std::string bytes, std::size_t length);
+
+            NodePtr         mRoot;
+            std::uint32_t   mSeed;  //!< State of the xorshift generator used for node priorities
+    };
+
+#endif
@@ -0,0 +1,392 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _USTRING_USTRINGVIEW_H_
+#define _USTRING_USTRINGVIEW_H_
+
+    #include "UChar.h"
+    #include "UCharSet.h"
+    #include "utf8/utf8.h"
+    #include <atomic>
+    #include <cstring>
+    #include <iterator>
+    #include <ostream>
+    #include <string>
+
+    class UStringSplitRange;
+
+    /*! Non-owning view of UTF-8 encoded characters
+     *
+     * A view is a pointer and a size in bytes, it never copies or allocates. It provides the const operations of
+     * UString, and subStr() returns another view of the same bytes. Every UString converts to a view implicitly,
+     * and so do C-strings and std::string, so functions taking a UStringView accept all of them without a copy.
+     * The view is only valid as long as the bytes it points to.
+     */
+    class UStringView
+    {
+        public:
+            typedef UChar value_type;
+
+            static const std::size_t npos = std::string::npos;
+
+            /*! Bidirectional iterator over the characters of a view
+             */
+            class ConstIterator : public std::iterator<std::bidirectional_iterator_tag, UChar>
+            {
+                public:
+                    typedef UChar value_type;
+                    using reference = UChar;
+
+                    /*! Create a empty Iterator without a reference to any part of a string
+                     */
+                    ConstIterator() = default;
+
+                    ConstIterator& operator++()     { utf8::next(mIter, mRangeEnd); return *this; }
+                    ConstIterator  operator++(int)  { ConstIterator temp = *this; operator++(); return temp; }
+                    ConstIterator& operator--()     { utf8::prior(mIter, mRangeStart); return *this; }
+                    ConstIterator  operator--(int)  { ConstIterator temp = *this; operator--(); return temp; }
+                    /*! The base iterator type
+                     * @return Pointer to the first byte of the character
+                     */
+                    const char*    base() const     { return mIter; }
+                    const UChar    operator*() const { auto temp = mIter; return UChar(utf8::next(temp, mRangeEnd)); }
+
+                    bool operator==(const ConstIterator& other) const { return( mIter == other.mIter ); }
+                    bool operator!=(const ConstIterator& other) const { return( mIter != other.mIter ); }
+
+                private:
+                    friend class UStringView;
+
+                    ConstIterator(const char* begin, const char* end, const char* pos)
+                        : mRangeStart(begin), mRangeEnd(end), mIter(pos)
+                    {
+                    }
+
+                    const char* mRangeStart = nullptr;
+                    const char* mRangeEnd   = nullptr;
+                    const char* mIter       = nullptr;
+            };
+
+            using ConstReverseIterator      = std::reverse_iterator<ConstIterator>;
+            // For STL compatibility
+            using iterator                  = ConstIterator;
+            using const_iterator            = ConstIterator;
+            using reverse_iterator          = ConstReverseIterator;
+            using const_reverse_iterator    = ConstReverseIterator;
+
+            /*! Create an empty view
+             */
+            USTRING_CONSTEXPR UStringView() USTRING_NOEXCEPT : mData(""), mSize(0), mLength(0) { }
+            /*! Create a view of a C-string
+             * @param cstr C-string, nullptr is an empty view
+             */
+            UStringView(const char* cstr) USTRING_NOEXCEPT
+                : mData(cstr ? cstr : ""), mSize(cstr ? std::strlen(cstr) : 0), mLength(npos)
+            {
+            }
+            /*! Create a view of UTF-8 bytes
+             * @param data First byte
+             * @param size Number of bytes
+             * @param length Number of code-points in the bytes if it is known, npos if not
+             */
+            USTRING_CONSTEXPR UStringView(const char* data, std::size_t size, std::size_t length=npos) USTRING_NOEXCEPT
+                : mData(data), mSize(size), mLength(length)
+            {
+            }
+            /*! Create a view of the bytes of a std::string
+             * @param str String holding UTF-8 bytes
+             */
+            UStringView(const std::string& str) USTRING_NOEXCEPT
+                : mData(str.data()), mSize(str.size()), mLength(npos)
+            {
+            }
+            /*! Copy a view, the length is copied with it if it was counted
+             */
+            UStringView(const UStringView& other) USTRING_NOEXCEPT
+                : mData(other.mData), mSize(other.mSize), mLength(other.mLength.load(std::memory_order_relaxed))
+            {
+            }
+
+            UStringView& operator=(const UStringView& other) USTRING_NOEXCEPT
+            {
+                mData = other.mData;
+                mSize = other.mSize;
+                mLength.store(other.mLength.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                return *this;
+            }
+
+            /*! Get the bytes of the view, they are not null-terminated
+             * @return Pointer to the first byte
+             */
+            USTRING_CONSTEXPR const char* data() const  { return mData; }
+            /*! Returns the size of the view in bytes
+             * @return The size of the view in bytes
+             */
+            USTRING_CONSTEXPR std::size_t size() const  { return mSize; }
+            /*! Returns the number of characters in the view, they are counted on the first call
+             * @return The number of characters
+             */
+            std::size_t length() const;
+            /*! Copy the bytes of the view into a std::string
+             * @return std::string
+             */
+            std::string toStdString() const     { return std::string(mData, mSize); }
+
+            /*! Get character at position idx
+             * @return Character, or UCHAR_CODE_NULL if idx is past the end
+             */
+            const UChar at(std::size_t idx) const;
+            /*! Get character at position idx
+             * @return Character, or UCHAR_CODE_NULL if idx is past the end
+             */
+            const UChar operator[](std::size_t idx) const { return at(idx); }
+
+            /*! Create a view of a sub-section of this view
+             * @param start Position of the first character
+             * @param len Number of characters or until the end if len is npos
+             * @return View of the same bytes
+             */
+            UStringView subStr(std::size_t start, std::size_t len=npos) const;
+
+            /*! Find a UChar character
+             * @param ch character to find
+             * @param start Position to begin searching from
+             * @return Position of the character if found, npos if not.
+             */
+            std::size_t find(UChar ch, std::size_t start=0) const;
+            /*! Find a string
+             * @param what String to search for
+             * @param start Position to begin searching from
+             * @return Position of the first character of the string if found, npos if not.
+             */
+            std::size_t find(UStringView what, std::size_t start=0) const;
+            /*! Find the last instance of a UChar character
+             * @param ch Character to search for
+             * @param pos Number of characters at the end to skip, or npos to search the whole view
+             * @return Position of the character if found, npos if not.
+             */
+            std::size_t findLastOf(UChar ch, std::size_t pos=npos) const;
+            /*! Find the last instance of a string
+             * @param what String to search for, an empty string is never found
+             * @param pos Number of characters at the end to skip, or npos to search the whole view
+             * @return Position of the last character of the string if found, npos if not.
+             */
+            std::size_t findLastOf(UStringView what, std::size_t pos=npos) const;
+
+            /*! Compare the bytes of two views
+             * @return Negative if this view sorts before other, zero if they are equal and positive otherwise
+             */
+            int compare(UStringView other) const;
+
+            /*! Split the view at every occurrence of a delimiter
+             *
+             * The fields are found one at a time while the range is iterated, in a single pass over the bytes.
+             * Delimiters next to each other or at either end produce empty fields, and an empty delimiter never
+             * matches, so the whole view is the only field.
+             * @param delim Delimiter between the fields
+             * @return Range of views of the fields
+             */
+            UStringSplitRange split(UStringView delim) const;
+            /*! Split the view at every character contained in a set
+             * @param delims Set of delimiter characters, the range keeps a copy
+             * @return Range of views of the fields
+             */
+            UStringSplitRange splitAny(const UCharSet& delims) const;
+            UStringSplitRange splitAny(UCharSet&& delims) const;
+
+            ConstIterator begin() const                 { return ConstIterator(mData, mData + mSize, mData); }
+            ConstIterator end() const                   { return ConstIterator(mData, mData + mSize, mData + mSize); }
+            ConstReverseIterator rbegin() const         { return ConstReverseIterator(end()); }
+            ConstReverseIterator rend() const           { return ConstReverseIterator(begin()); }
+
+        private:
+            template<typename Allocator> friend class BasicUString;
+            friend class UStringRope;
+            friend USTRING_CONSTEXPR UStringView operator"" _us(const char* str, std::size_t size);
+
+            /*! Get the byte offset of the character at pos, or the size of the view if pos is past the end
+             */
+            std::size_t byteOffset(std::size_t pos) const;
+            /*! Count the bytes starting a UTF-8 sequence, this is branch-free and can be vectorized
+             */
+            static std::size_t countCodePoints(const char* data, std::size_t size)
+            {
+                std::size_t count = 0;
+                for( std::size_t i = 0; i < size; i++ )
+                    count += ( (static_cast<unsigned char>(data[i]) & 0xC0) != 0x80 );
+                return count;
+            }
+
+            // Validation of literals, written as single expressions so they can be evaluated at compile-time with
+            // C++11 constexpr. Every byte is checked on its own and the results are summed by splitting the range
+            // in halves, which keeps the recursion depth logarithmic.
+            static USTRING_CONSTEXPR unsigned char byteAt(const char* str, std::size_t i)
+            {
+                return static_cast<unsigned char>(str[i]);
+            }
+            static USTRING_CONSTEXPR bool isContinuation(unsigned char byte)
+            {
+                return( (byte & 0xC0) == 0x80 );
+            }
+            //! Number of bytes in the sequence started by a lead byte, 0 if the byte can never start one
+            static USTRING_CONSTEXPR std::size_t sequenceSize(unsigned char byte)
+            {
+                return( byte < 0x80 ? 1 : byte < 0xC2 ? 0 : byte < 0xE0 ? 2 : byte < 0xF0 ? 3 : byte < 0xF5 ? 4 : 0 );
+            }
+            //! The second byte rules out overlong sequences, surrogates and code-points above U+10FFFF
+            static USTRING_CONSTEXPR bool isValidSecond(unsigned char lead, unsigned char byte)
+            {
+                return( lead == 0xE0 ? (byte >= 0xA0 && byte <= 0xBF) :
+                        lead == 0xED ? (byte >= 0x80 && byte <= 0x9F) :
+                        lead == 0xF0 ? (byte >= 0x90 && byte <= 0xBF) :
+                        lead == 0xF4 ? (byte >= 0x80 && byte <= 0x8F) : isContinuation(byte) );
+            }
+            static USTRING_CONSTEXPR bool isValidSequence(const char* str, std::size_t size, std::size_t i, std::size_t count)
+            {
+                return( count == 1 || (count != 0 && i + count <= size && isValidSecond(byteAt(str, i), byteAt(str, i + 1))
+                                       && (count < 3 || isContinuation(byteAt(str, i + 2)))
+                                       && (count < 4 || isContinuation(byteAt(str, i + 3)))) );
+            }
+            //! A continuation byte is valid if the closest lead byte before it starts a sequence reaching it
+            static USTRING_CONSTEXPR bool isClaimed(const char* str, std::size_t i)
+            {
+                return( (i >= 1 && !isContinuation(byteAt(str, i - 1)) && sequenceSize(byteAt(str, i - 1)) > 1) ||
+                        (i >= 2 && isContinuation(byteAt(str, i - 1)) && !isContinuation(byteAt(str, i - 2)) && sequenceSize(byteAt(str, i - 2)) > 2) ||
+                        (i >= 3 && isContinuation(byteAt(str, i - 1)) && isContinuation(byteAt(str, i - 2)) && !isContinuation(byteAt(str, i - 3)) && sequenceSize(byteAt(str, i - 3)) > 3) );
+            }
+            //! 1 if the byte at i starts a valid character, 0 if it continues one, throws if it is invalid
+            static USTRING_CONSTEXPR std::size_t checkByte(const char* str, std::size_t size, std::size_t i)
+            {
+                return( isContinuation(byteAt(str, i)) ? (isClaimed(str, i) ? 0 : throw utf8::invalid_utf8(byteAt(str, i))) :
+                        isValidSequence(str, size, i, sequenceSize(byteAt(str, i))) ? 1 : throw utf8::invalid_utf8(byteAt(str, i)) );
+            }
+            //! Number of characters in the bytes [first, last), throws if any of them is invalid
+            static USTRING_CONSTEXPR std::size_t checkedLength(const char* str, std::size_t size, std::size_t first, std::size_t last)
+            {
+                return( last - first == 0 ? 0 :
+                        last - first == 1 ? checkByte(str, size, first) :
+                        checkedLength(str, size, first, first + (last - first) / 2) + checkedLength(str, size, first + (last - first) / 2, last) );
+            }
+
+            const char*                         mData;
+            std::size_t                         mSize;
+            mutable std::atomic<std::size_t>    mLength;    //!< Number of code-points, npos if they need to be counted
+    };
+
+    /*! Lazy range of the fields of a split string, returned by split() and splitAny()
+     *
+     * Each field is a view of the bytes of the string that was split, the range does not copy them. The delimiters
+     * are copied into the range, so temporaries can be passed. The iterators are valid as long as the range.
+     */
+    class UStringSplitRange
+    {
+        public:
+            /*! Forward iterator over the fields, the next field is found when the iterator is incremented
+             */
+            class Iterator : public std::iterator<std::forward_iterator_tag, UStringView>
+            {
+                public:
+                    typedef UStringView value_type;
+                    using reference = UStringView;
+
+                    /*! Create a empty Iterator, it is equal to the end of any range
+                     */
+                    Iterator() = default;
+
+                    Iterator& operator++();
+                    Iterator  operator++(int)       { Iterator temp = *this; operator++(); return temp; }
+                    /*! Get the current field
+                     * @return View of the field
+                     */
+                    UStringView operator*() const   { return UStringView(mField, mFieldEnd - mField, mFieldLength); }
+
+                    bool operator==(const Iterator& other) const { return( mField == other.mField ); }
+                    bool operator!=(const Iterator& other) const { return( mField != other.mField ); }
+
+                private:
+                    friend class UStringSplitRange;
+
+                    explicit Iterator(const UStringSplitRange* range);
+                    /*! Find the delimiter ending the field starting at mField
+                     */
+                    void findFieldEnd();
+
+                    const UStringSplitRange*    mRange          = nullptr;
+                    const char*                 mField          = nullptr;  //!< Start of the field, nullptr at the end
+                    const char*                 mFieldEnd       = nullptr;
+                    std::size_t                 mFieldLength    = UStringView::npos;
+                    std::size_t                 mDelimSize      = 0;        //!< Size of the delimiter after the field, 0 for the last field
+            };
+
+            /*! Create a range splitting str at every occurrence of delim
+             */
+            UStringSplitRange(UStringView str, UStringView delim)
+                : mString(str), mDelim(delim.data(), delim.size()), mSplitAny(false)
+            {
+            }
+            /*! Create a range splitting str at every character in delims
+             */
+            UStringSplitRange(UStringView str, UCharSet delims)
+                : mString(str), mDelims(std::move(delims)), mSplitAny(true)
+            {
+            }
+
+            Iterator begin() const  { return Iterator(this); }
+            Iterator end() const    { return Iterator(); }
+
+        private:
+            UStringView     mString;
+            std::string     mDelim;     //!< Delimiter for split()
+            UCharSet        mDelims;    //!< Set of delimiter characters for splitAny()
+            bool            mSplitAny;
+    };
+
+    /*! Create a view of a UTF-8 string literal, for example u8"ключ"_us
+     *
+     * The literal is validated and its characters are counted when the view is constructed. In a constant expression
+     * such as the initializer of a constexpr variable this happens at compile-time, and invalid UTF-8 is a compile
+     * error. Otherwise invalid UTF-8 throws utf8::invalid_utf8. The view points to the static storage of the literal
+     * and converts to a UString without counting the characters again.
+     * @return View of the literal
+     */
+    USTRING_CONSTEXPR UStringView operator"" _us(const char* str, std::size_t size)
+    {
+        return UStringView(str, size, UStringView::checkedLength(str, size, 0, size));
+    }
+
+    inline UStringSplitRange UStringView::split(UStringView delim) const        { return UStringSplitRange(*this, delim); }
+    inline UStringSplitRange UStringView::splitAny(const UCharSet& delims) const { return UStringSplitRange(*this, delims); }
+    inline UStringSplitRange UStringView::splitAny(UCharSet&& delims) const     { return UStringSplitRange(*this, std::move(delims)); }
+
+    inline bool operator==(UStringView str1, UStringView str2)
+    {
+        return( str1.size() == str2.size() && std::memcmp(str1.data(), str2.data(), str1.size()) == 0 );
+    }
+    inline bool operator!=(UStringView str1, UStringView str2)  { return !( str1 == str2 ); }
+    inline bool operator<(UStringView str1, UStringView str2)   { return( str1.compare(str2) < 0 ); }
+
+    inline std::ostream& operator<<(std::ostream& os, UStringView str)
+    {
+        return os.write(str.data(), str.size());
+    }
+
+#endif
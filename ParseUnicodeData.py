@@ -26,6 +26,7 @@
 # into separate files.
 
 import os.path
+import sys
 from collections import defaultdict
 
 UNICODE_DATA_URL    = "unicode.org"
@@ -36,6 +37,36 @@ CASE_NONE           = "00"
 CASE_UPPER          = "01"
 CASE_LOWER          = "02"
 CASE_TITLE          = "03"
+CASE_INVALID        = "04"
+
+# The property lookup table splits the BMP into blocks of 2^PROPERTY_SHIFT code-points, identical
+# blocks are only stored once. The sparse supplementary planes are stored as sorted ranges instead,
+# each entry is (first code-point << RANGE_SHIFT) | record.
+PROPERTY_SHIFT      = 8
+PROPERTY_BLOCK_SIZE = 1 << PROPERTY_SHIFT
+BMP_MAX             = 0xFFFF
+RANGE_SHIFT         = 11
+
+# Flags for the first 256 code-points, the names have to match the UCHAR_FLAG_* macros used in UChar.h
+LATIN1_SIZE         = 0x100
+FLAG_LETTER         = 0x01
+FLAG_NUMBER         = 0x02
+FLAG_PUNCTUATION    = 0x04
+FLAG_SYMBOL         = 0x08
+FLAG_CONTROL        = 0x10
+FLAG_SPACE          = 0x20
+FLAG_UPPER          = 0x40
+FLAG_LOWER          = 0x80
+
+latin1Categories    = [ ('LETTER',      ['Lu', 'Ll', 'Lt', 'Lm', 'Lo'],             FLAG_LETTER), 
+                        ('NUMBER',      ['Nd', 'Nl', 'No'],                         FLAG_NUMBER),
+                        ('PUNCTUATION', ['Pc', 'Pd', 'Ps', 'Pe', 'Pi', 'Pf', 'Po'], FLAG_PUNCTUATION),
+                        ('SYMBOL',      ['Sm', 'Sc', 'Sk', 'So'],                   FLAG_SYMBOL),
+                        ('CONTROL',     ['Cc', 'Cf'],                               FLAG_CONTROL),
+                        ('SPACE',       ['Zs'],                                     FLAG_SPACE) ]
+
+# Control characters that are treated as whitespace (tab, new line, vertical tab, form feed, carriage return, next line)
+latin1Whitespace    = [ 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x85 ]
 
 # These have to be in the same order is the UChar::Category enum
 categories          = [ ('Mn',  0), ('Mc',  1), ('Me',  2), ('Nd',  3), ('Nl',  4), ('No',  5), ('Zs',  6), ('Zl',  7), ('Zp',  8), ('Cc',  9), 
@@ -46,16 +77,10 @@ categories          = [ ('Mn',  0), ('Mc',  1), ('Me',  2), ('Nd',  3), ('Nl',
 directions          = [ ('L', 0), ('R', 1), ('EN', 2), ('ES', 3), ('ET', 4), ('AN', 5), ('CS', 6), ('B', 7), ('S', 8), ('WS', 9), ('ON', 10), ('LRE', 11), 
                         ('LRO', 12), ('AL', 13), ('RLE', 14), ('RLO', 15), ('PDF', 16), ('NSM', 17), ('BN', 18), ('LRI', 19), ('RLI', 20), ('FSI', 21), ('PDI', 22) ]
 
-letters             = []
-numbers             = []
-controls            = []
-whitespace          = []
-linebreaks          = []
-punctuations        = []
-symbols             = []
-surrogates          = []
-marks               = []
-others              = []
+properties          = {}
+# Distinct (upper, lower, title) deltas, the first entry is used by every code-point without a mapping
+caseMappings        = [(0, 0, 0)]
+latin1Flags         = [0] * LATIN1_SIZE
 
 SourceHeader        = """\
 //   UString - UTF-8 C++ Library
@@ -95,11 +120,58 @@ def searchDictionary(dictToSearch, whatToSearchFor):
         if t[0] == whatToSearchFor:
             return t[1]
 
-def writeSimpleList(f, l, name):
-    f.write("    UCharEntry " + name + "[" + str(len(l)+1) + "] = \n    {\n")
-    for entry in l:
-        f.write("        {0x" + entry[0] + ", " + str(entry[1]) + ", " + str(entry[2]) + "},\n")
-    f.write("    };\n\n")
+def smallestType(count):
+    if count <= 0x100:
+        return "std::uint8_t"
+    return "std::uint16_t"
+
+def buildLookupTables(values, default):
+    # Record 0 is used for every code-point without a value
+    records     = [default]
+    recordIndex = {default: 0}
+    blocks      = []
+    blockIndex  = {}
+    stage1      = []
+    ranges      = []
+
+    def findRecord(codePoint):
+        record = values.get(codePoint, default)
+        if record not in recordIndex:
+            recordIndex[record] = len(records)
+            records.append(record)
+        return recordIndex[record]
+
+    for blockStart in range(0, BMP_MAX + 1, PROPERTY_BLOCK_SIZE):
+        block = tuple(findRecord(codePoint) for codePoint in range(blockStart, blockStart + PROPERTY_BLOCK_SIZE))
+        if block not in blockIndex:
+            blockIndex[block] = len(blocks)
+            blocks.append(block)
+        stage1.append(blockIndex[block])
+
+    for codePoint in range(BMP_MAX + 1, int(CODE_POINT_MAX, 16) + 1):
+        record = findRecord(codePoint)
+        if not ranges or (ranges[-1] & ((1 << RANGE_SHIFT) - 1)) != record:
+            ranges.append((codePoint << RANGE_SHIFT) | record)
+
+    if len(records) > (1 << RANGE_SHIFT):
+        raise Exception("Too many records to store in a range entry")
+
+    stage2 = [index for block in blocks for index in block]
+    return records, stage1, stage2, ranges
+
+def mappingDelta(codePoint, mapping):
+    if mapping == CODE_POINT_NULL:
+        return 0
+    return int(mapping, 16) - int(codePoint, 16)
+
+def writeTable(f, declaration, values, perLine, indent):
+    f.write(indent + declaration + " = \n" + indent + "{\n")
+    for i in range(0, len(values), perLine):
+        f.write(indent + "    " + " ".join(value + "," for value in values[i:i+perLine]) + "\n")
+    f.write(indent + "};\n\n")
+
+# With --constexpr the tables are defined as constexpr in UnicodeData.h instead of UnicodeData.cpp
+constexprTables     = "--constexpr" in sys.argv[1:]
 
 print("Unicode Data Parser")
 
@@ -114,63 +186,87 @@ for line in open("UnicodeData.txt"):
 
     parts = [part.strip() for part in line[:-1].strip().split(";")]
 
+    # A skipped line would leave its code-points unassigned in the packed tables, so stop the build instead
     if len(parts) != 15:
-        print "Error: line is invalid"
+        raise Exception("Invalid line in UnicodeData.txt: " + line.strip())
     if parts[12] == "":
         parts[12] = CODE_POINT_NULL
     if parts[13] == "":
         parts[13] = CODE_POINT_NULL
     if parts[14] == "":
         parts[14] = CODE_POINT_NULL
+    codePoint = int(parts[0], 16)
+
+    # Case mappings are stored as the distance to the mapped code-point so most letters share a record
+    characterCase = CASE_INVALID
     if parts[2] == "Lu":
-        letters.append((parts[0], CASE_UPPER, parts[12], parts[13], parts[14], searchDictionary(categories, parts[2]), parts[4]))
-    if parts[2] == "Ll":
-        letters.append((parts[0], CASE_LOWER, parts[12], parts[13], parts[14], searchDictionary(categories, parts[2]), parts[4]))
-    if parts[2] == "Lt":
-        letters.append((parts[0], CASE_TITLE, parts[12], parts[13], parts[14], searchDictionary(categories, parts[2]), parts[4]))
-    if parts[2] == "Lm":
-        letters.append((parts[0], CASE_NONE, parts[12], parts[13], parts[14], searchDictionary(categories, parts[2]), parts[4]))
-    if parts[2] == "Lo":
-        letters.append((parts[0], CASE_NONE, parts[12], parts[13], parts[14], searchDictionary(categories, parts[2]), parts[4]))
-
-    # Numbers
-    if parts[2] == "Nd" or parts[2] == "Nl" or parts[2] == "No":
-        numbers.append((parts[0], searchDictionary(categories, parts[2]), searchDictionary(directions, parts[4])))
-
-    # Whitespace
-    if parts[2] == "Zs":
-        whitespace.append((parts[0], searchDictionary(categories, parts[2]), searchDictionary(directions, parts[4])))
-
-    # Controls
-    if parts[2] == "Cc" or parts[2] == "Cf":
-        controls.append((parts[0], searchDictionary(categories, parts[2]), searchDictionary(directions, parts[4])))
-
-    # Line Breaks
-    if parts[2] == "Zl" or parts[2] == "Zp":
-        linebreaks.append((parts[0], searchDictionary(categories, parts[2]), searchDictionary(directions, parts[4])))
-
-    # Punctuation
-    if parts[2] == "Pc" or parts[2] == "Pd" or parts[2] == "Ps" or parts[2] == "Pe" or parts[2] == "Pi" or parts[2] == "Pf" or parts[2] == "Po":
-        punctuations.append((parts[0], searchDictionary(categories, parts[2]), searchDictionary(directions, parts[4])))
-
-    # Symbols
-    if parts[2] == "Sm" or parts[2] == "Sc" or parts[2] == "Sk" or parts[2] == "So":
-        symbols.append((parts[0], searchDictionary(categories, parts[2]), searchDictionary(directions, parts[4])))
-
-    # Surrogates
-    if parts[2] == "Cs":
-        surrogates.append((parts[0], searchDictionary(categories, parts[2]), searchDictionary(directions, parts[4])))
-
-    # Marks
-    if parts[2] == "Mn" or parts[2] == "Mc" or parts[2] == "Me":
-        marks.append((parts[0], searchDictionary(categories, parts[2]), searchDictionary(directions, parts[4])))
-
-    # Others
-    if parts[2] == "Co" or parts[2] == "Cn":
-        others.append((parts[0], searchDictionary(categories, parts[2]), searchDictionary(directions, parts[4])))
+        characterCase = CASE_UPPER
+    elif parts[2] == "Ll":
+        characterCase = CASE_LOWER
+    elif parts[2] == "Lt":
+        characterCase = CASE_TITLE
+    elif parts[2] == "Lm" or parts[2] == "Lo":
+        characterCase = CASE_NONE
+    caseMapping = (mappingDelta(parts[0], parts[12]), mappingDelta(parts[0], parts[13]), mappingDelta(parts[0], parts[14]))
+    if caseMapping not in caseMappings:
+        caseMappings.append(caseMapping)
+
+    # Every property of a code-point is packed into one record so a single lookup answers all of them
+    properties[codePoint] = (searchDictionary(categories, parts[2]), searchDictionary(directions, parts[4]),
+                             int(characterCase, 16), caseMappings.index(caseMapping))
+
+    # Large blocks such as CJK ideographs and Hangul syllables are listed as a <..., First> and <..., Last> pair,
+    # every code-point in between shares the same properties
+    if parts[1].endswith(", First>"):
+        rangeStart = codePoint
+    elif parts[1].endswith(", Last>"):
+        for rangeCodePoint in range(rangeStart + 1, codePoint):
+            properties[rangeCodePoint] = properties[codePoint]
+
+    # Flags for the Latin-1 fast path in UChar
+    if codePoint < LATIN1_SIZE:
+        for flag in latin1Categories:
+            if parts[2] in flag[1]:
+                latin1Flags[codePoint] |= flag[2]
+        if parts[2] == "Lu":
+            latin1Flags[codePoint] |= FLAG_UPPER
+        elif parts[2] == "Ll":
+            latin1Flags[codePoint] |= FLAG_LOWER
+
+for codePoint in latin1Whitespace:
+    latin1Flags[codePoint] |= FLAG_SPACE
 
 print(" - Parsed UnicodeData.txt")
 
+if len(caseMappings) > 256:
+    raise Exception("Too many case mappings to index with a std::uint8_t")
+
+# Code-points missing from UnicodeData.txt are unassigned, UAX #9 gives them the default direction L
+unassigned = (searchDictionary(categories, "Cn"), searchDictionary(directions, "L"), int(CASE_INVALID, 16), 0)
+propertyRecords, propertyStage1, propertyStage2, propertyRanges = buildLookupTables(properties, unassigned)
+propertyStage1Type = smallestType(len(propertyStage2) // PROPERTY_BLOCK_SIZE)
+propertyStage2Type = smallestType(len(propertyRecords))
+
+# Code-points above UCHAR_CODE_MAX use the last record, it is never referenced by the lookup tables
+propertyRecords.append((len(categories), len(directions), int(CASE_INVALID, 16), 0))
+
+# (C++ name, UnicodeDataTables member, element type, size, values, values per line)
+tables = [ ("UCharLatin1Flags",    "latin1Flags",    "std::uint8_t",     "UCHAR_LATIN1_MAX+1",        [str(flags) for flags in latin1Flags], 16),
+           ("UCharProperties",     "properties",     "UCharProperty",    "UCHAR_NUM_PROPERTIES",      ["{" + ", ".join(str(value) for value in r) + "}" for r in propertyRecords], 1),
+           ("UCharPropertyStage1", "propertyStage1", propertyStage1Type, "UCHAR_NUM_PROPERTY_STAGE1", [str(i) for i in propertyStage1], 16),
+           ("UCharPropertyStage2", "propertyStage2", propertyStage2Type, "UCHAR_NUM_PROPERTY_STAGE2", [str(i) for i in propertyStage2], 16),
+           ("UCharPropertyRanges", "propertyRanges", "std::uint32_t",    "UCHAR_NUM_PROPERTY_RANGES", ["0x" + format(r, "08X") for r in propertyRanges], 8),
+           ("UCharCaseMappings",   "caseMappings",   "UCharCaseMapping", "UCHAR_NUM_CASE_MAPPINGS",   ["{" + ", ".join(str(delta) for delta in r) + "}" for r in caseMappings], 1) ]
+
+print(" - Built property tables")
+
+# Every table is const plain data without pointers so it is placed in read-only memory that processes share
+typeSizes = { "std::uint8_t": 1, "std::uint16_t": 2, "std::uint32_t": 4, "UCharProperty": 4, "UCharCaseMapping": 12 }
+footprint = 0
+for table in tables:
+    footprint += typeSizes[table[2]] * len(table[4])
+print(" - Table footprint: " + str(footprint) + " bytes")
+
 f = open("Include/UString/UnicodeData.h", "w")
 f.write(SourceHeader)
 f.write("\n#ifndef _USTRING_UNICODE_DATA_H_\n")
@@ -185,49 +281,63 @@ f.write("    #define UCHAR_CASE_NONE          0\n")
 f.write("    #define UCHAR_CASE_UPPER         1\n")
 f.write("    #define UCHAR_CASE_LOWER         2\n")
 f.write("    #define UCHAR_CASE_TITLE         3\n")
+f.write("    #define UCHAR_CASE_INVALID       4\n")
+f.write("\n")
+f.write("    #define UCHAR_LATIN1_MAX         0x" + format(LATIN1_SIZE - 1, "X") + "\n")
+for flag in latin1Categories:
+    f.write("    #define UCHAR_FLAG_" + flag[0].ljust(14) + "0x" + format(flag[2], "02X") + "\n")
+f.write("    #define UCHAR_FLAG_UPPER         0x" + format(FLAG_UPPER, "02X") + "\n")
+f.write("    #define UCHAR_FLAG_LOWER         0x" + format(FLAG_LOWER, "02X") + "\n")
 f.write("\n")
-f.write("    #define UCHAR_NUM_LETTERS        " + str(len(letters)) + "\n")
-f.write("    #define UCHAR_NUM_NUMBERS        " + str(len(numbers)) + "\n")
-f.write("    #define UCHAR_NUM_WHITESPACE     " + str(len(whitespace)) + "\n")
-f.write("    #define UCHAR_NUM_CONTROLS       " + str(len(controls)) + "\n")
-f.write("    #define UCHAR_NUM_LINEBREAKS     " + str(len(linebreaks)) + "\n")
-f.write("    #define UCHAR_NUM_PUNCTUATIONS   " + str(len(punctuations)) + "\n")
-f.write("    #define UCHAR_NUM_SYMBOLS        " + str(len(symbols)) + "\n")
-f.write("    #define UCHAR_NUM_MARKS          " + str(len(marks)) + "\n")
-f.write("    #define UCHAR_NUM_SURROGATES     " + str(len(surrogates)) + "\n")
-f.write("    #define UCHAR_NUM_OTHERS         " + str(len(others)) + "\n")
+f.write("    #define UCHAR_PROPERTY_SHIFT     " + str(PROPERTY_SHIFT) + "\n")
+f.write("    #define UCHAR_PROPERTY_MASK      0x" + format(PROPERTY_BLOCK_SIZE - 1, "X") + "\n")
+f.write("    #define UCHAR_BMP_MAX            0x" + format(BMP_MAX, "X") + "\n")
+f.write("    #define UCHAR_RANGE_SHIFT        " + str(RANGE_SHIFT) + "\n")
+f.write("    #define UCHAR_RANGE_MASK         0x" + format((1 << RANGE_SHIFT) - 1, "X") + "\n")
+f.write("    #define UCHAR_NUM_PROPERTIES     " + str(len(propertyRecords)) + "\n")
+f.write("    #define UCHAR_PROPERTY_INVALID   " + str(len(propertyRecords) - 1) + "\n")
+f.write("    #define UCHAR_NUM_PROPERTY_STAGE1 " + str(len(propertyStage1)) + "\n")
+f.write("    #define UCHAR_NUM_PROPERTY_STAGE2 " + str(len(propertyStage2)) + "\n")
+f.write("    #define UCHAR_NUM_PROPERTY_RANGES " + str(len(propertyRanges)) + "\n")
+f.write("    #define UCHAR_NUM_CASE_MAPPINGS  " + str(len(caseMappings)) + "\n")
 f.write("\n")
 
-f.write("    struct UCharLetter\n")
+f.write("    struct UCharProperty\n")
 f.write("    {\n")
-f.write("        std::uint32_t  codePoint;\n")
-f.write("        std::uint8_t   characterCase;\n")
-f.write("        std::uint32_t  upperVersion;\n")
-f.write("        std::uint32_t  lowerVersion;\n")
-f.write("        std::uint32_t  titleVersion;\n")
 f.write("        std::uint8_t   category;\n")
 f.write("        std::uint8_t   direction;\n")
+f.write("        std::uint8_t   characterCase;\n")
+f.write("        std::uint8_t   caseMapping;\n")
 f.write("    };\n")
 f.write("\n")
 
-f.write("   struct UCharEntry\n")
-f.write("   {\n")
-f.write("       std::uint32_t  codePoint;\n")
-f.write("       std::uint8_t   category;\n")
-f.write("       std::uint8_t   direction;\n")
-f.write("   };\n")
+f.write("    struct UCharCaseMapping\n")
+f.write("    {\n")
+f.write("        std::int32_t   upperDelta;\n")
+f.write("        std::int32_t   lowerDelta;\n")
+f.write("        std::int32_t   titleDelta;\n")
+f.write("    };\n")
 f.write("\n")
 
-f.write("    extern UCharLetter UCharLetters[UCHAR_NUM_LETTERS+1];\n")
-f.write("    extern UCharEntry  UCharNumbers[UCHAR_NUM_NUMBERS+1];\n")
-f.write("    extern UCharEntry  UCharWhitespace[UCHAR_NUM_WHITESPACE+1];\n")
-f.write("    extern UCharEntry  UCharControls[UCHAR_NUM_CONTROLS+1];\n")
-f.write("    extern UCharEntry  UCharLinebreaks[UCHAR_NUM_LINEBREAKS+1];\n")
-f.write("    extern UCharEntry  UCharPunctuations[UCHAR_NUM_PUNCTUATIONS+1];\n")
-f.write("    extern UCharEntry  UCharSymbols[UCHAR_NUM_SYMBOLS+1];\n")
-f.write("    extern UCharEntry  UCharSurrogates[UCHAR_NUM_SURROGATES+1];\n")
-f.write("    extern UCharEntry  UCharOthers[UCHAR_NUM_OTHERS+1];\n")
-f.write("    extern UCharEntry  UCharMarks[UCHAR_NUM_MARKS+1];\n")
+if constexprTables:
+    f.write("    #define USTRING_CONSTEXPR_TABLES\n")
+    f.write("\n")
+    f.write("    // The tables are static members of a class template so every translation unit shares a single copy\n")
+    f.write("    template<typename T = void>\n")
+    f.write("    struct UnicodeDataTables\n")
+    f.write("    {\n")
+    for table in tables:
+        writeTable(f, "static constexpr " + table[2] + " " + table[1] + "[" + table[3] + "]", table[4], table[5], "        ")
+    f.write("    };\n")
+    f.write("\n")
+    for table in tables:
+        f.write("    template<typename T> constexpr " + table[2] + " UnicodeDataTables<T>::" + table[1] + "[" + table[3] + "];\n")
+    f.write("\n")
+    for table in tables:
+        f.write("    static constexpr const " + table[2] + " (&" + table[0] + ")[" + table[3] + "] = UnicodeDataTables<>::" + table[1] + ";\n")
+else:
+    for table in tables:
+        f.write("    extern const " + table[2] + " " + table[0] + "[" + table[3] + "];\n")
 
 f.write("\n")
 f.write("#endif\n")
@@ -240,21 +350,11 @@ f.write(SourceHeader)
 f.write("\n#include \"UnicodeData.h\"\n")
 f.write("\n")
 
-f.write("    UCharLetter UCharLetters[UCHAR_NUM_LETTERS+1] = \n    {\n")
-for letter in letters:
-  f.write("        {0x" + letter[0] + ", 0x" + letter[1] + ", 0x" + letter[2] + ", 0x" + letter[3] + ", 0x" + letter[4] + ", " + str(letter[5]) + ", " + str(searchDictionary(directions, letter[6])) + "},\n")
-f.write("    };\n")
-f.write("\n")
-
-writeSimpleList(f, numbers, "UCharNumbers")
-writeSimpleList(f, whitespace, "UCharWhitespace")
-writeSimpleList(f, controls, "UCharControls")
-writeSimpleList(f, linebreaks, "UCharLinebreaks")
-writeSimpleList(f, punctuations, "UCharPunctuations")
-writeSimpleList(f, symbols, "UCharSymbols")
-writeSimpleList(f, surrogates, "UCharSurrogates")
-writeSimpleList(f, marks, "UCharMarks")
-writeSimpleList(f, others, "UCharOthers")
+if constexprTables:
+    f.write("// The tables are defined in UnicodeData.h\n")
+else:
+    for table in tables:
+        writeTable(f, "const " + table[2] + " " + table[0] + "[" + table[3] + "]", table[4], table[5], "    ")
 
 f.close();
 print(" - Generated UnicodeData.cpp")    
@@ -0,0 +1,55 @@
+#   UString - UTF-8 C++ Library
+#     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+#     http://github.com/zordtk/ustring
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Checks that the generated Unicode tables of a built library are in read-only data, so every process
+# loading the library shares their pages, and reports how much space they take.
+#
+# Usage: cmake -DNM=<nm> -DLIBRARY=<library> -P CheckUnicodeData.cmake
+
+execute_process(COMMAND ${NM} -S -t d ${LIBRARY} OUTPUT_VARIABLE SYMBOLS RESULT_VARIABLE RESULT ERROR_QUIET)
+if( NOT RESULT EQUAL 0 )
+    message(WARNING "Could not read the symbols of ${LIBRARY}, skipping the Unicode table check")
+    return()
+endif()
+
+# Only keep the defined tables, other symbols can contain characters that break CMake lists
+string(REGEX MATCHALL "[0-9]+ [0-9]+ [A-Za-z] UChar[A-Z][A-Za-z0-9]*\n" TABLES "${SYMBOLS}")
+
+set(TABLE_BYTES 0)
+set(WRITABLE_TABLES)
+foreach( TABLE ${TABLES} )
+    if( TABLE MATCHES "^[0-9]+ ([0-9]+) ([A-Za-z]) (UChar[A-Z][A-Za-z0-9]*)\n$" )
+        set(TABLE_SIZE ${CMAKE_MATCH_1})
+        set(TABLE_TYPE ${CMAKE_MATCH_2})
+        set(TABLE_NAME ${CMAKE_MATCH_3})
+        if( NOT TABLE_TYPE STREQUAL "R" AND NOT TABLE_TYPE STREQUAL "r" )
+            list(APPEND WRITABLE_TABLES ${TABLE_NAME})
+        endif()
+        math(EXPR TABLE_BYTES "${TABLE_BYTES} + ${TABLE_SIZE}")
+    endif()
+endforeach()
+
+if( WRITABLE_TABLES )
+    message(FATAL_ERROR "Unicode tables are not in read-only data: ${WRITABLE_TABLES}")
+endif()
+
+message(STATUS "Unicode tables: ${TABLE_BYTES} bytes of read-only data")
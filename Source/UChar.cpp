@@ -22,6 +22,7 @@
                            
 #include "UChar.h"
 #include "UnicodeData.h"
+#include <algorithm>
 #include <cstring>
 
 struct UCharCategoriesComp {
@@ -30,18 +31,6 @@ struct UCharCategoriesComp {
     }
 };
 
-UChar::UChar() USTRING_NOEXCEPT
-    : mChar(UCHAR_CODE_NULL)
-{
-
-}
-
-UChar::UChar(ValueType codePoint) USTRING_NOEXCEPT
-    : mChar(codePoint)
-{
-    
-}
-
 UChar& UChar::assign(UChar codePoint)
 {
     mChar = codePoint;
@@ -54,294 +43,83 @@ UChar& UChar::operator=(UChar codePoint)
     return *this;
 }
 
-bool UChar::isSpace(ValueType codePoint)
-{
-    if( codePoint > UCHAR_CODE_MAX )
-        return false;
-    
-    return( codePoint == 0x20 || ( codePoint <= 0x0D && codePoint >= 0x09 ) || ( codePoint > 127 && ( codePoint == 0x85 || 
-            codePoint == 0xA0 || isCodePointInArray(UCharWhitespace, UCHAR_NUM_WHITESPACE, codePoint))) );
-}
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Bulk Classification                                                               ///
+/////////////////////////////////////////////////////////////////////////////////////////
 
-bool UChar::isLetter(ValueType codePoint)
-{
-    for( std::uint32_t i = 0; i < UCHAR_NUM_LETTERS; i++ )
-    {
-        if( UCharLetters[i].codePoint == codePoint )
-            return true;
-    }
-    return false;
-}
+// Code-points are processed in blocks, a block holding only Latin-1 is answered with a branch-free
+// loop over a single table that the compiler can vectorize. Other blocks fall back to the full lookup.
+static const std::size_t ClassifyBlockSize = 16;
 
-bool UChar::isControl(ValueType codePoint)
+template<typename Latin1Func, typename LookupFunc>
+static void classifyBlocks(const UChar::ValueType* codePoints, std::size_t count, std::uint8_t* out,
+                           Latin1Func latin1, LookupFunc lookup)
 {
-    if( codePoint > UCHAR_CODE_MAX )
-        return false;
-    return( isCodePointInArray(UCharControls, UCHAR_NUM_CONTROLS, codePoint) );
-}
-
-bool UChar::isNumber(ValueType codePoint)
-{
-    if( codePoint > UCHAR_CODE_MAX )
-        return false;
-    return( isCodePointInArray(UCharNumbers, UCHAR_NUM_NUMBERS, codePoint) );
-}
-
-bool UChar::isLineBreak(ValueType codePoint)
-{
-    if( codePoint > UCHAR_CODE_MAX )
-        return false;
-    return( isCodePointInArray(UCharLinebreaks, UCHAR_NUM_LINEBREAKS, codePoint) );
-}
-
-bool UChar::isSymbol(ValueType codePoint)
-{
-    if( codePoint > UCHAR_CODE_MAX )
-        return false;
-    return( isCodePointInArray(UCharSymbols, UCHAR_NUM_SYMBOLS, codePoint) );
-}
-
-bool UChar::isPunctuation(ValueType codePoint)
-{
-    if( codePoint > UCHAR_CODE_MAX )
-        return false;
-    return( isCodePointInArray(UCharPunctuations, UCHAR_NUM_PUNCTUATIONS, codePoint) );
-}
+    for( std::size_t start = 0; start < count; start += ClassifyBlockSize )
+    {
+        std::size_t end = std::min(start + ClassifyBlockSize, count);
 
-bool UChar::isSurrogate(ValueType codePoint)
-{
-    if( codePoint > UCHAR_CODE_MAX )
-        return false;
-    return( isCodePointInArray(UCharSurrogates, UCHAR_NUM_SURROGATES, codePoint) );
-} 
+        UChar::ValueType combined = 0;
+        for( std::size_t i = start; i < end; i++ )
+            combined |= codePoints[i];
 
-bool UChar::isNull(ValueType codePoint)
-{
-    return( codePoint == UCHAR_CODE_NULL );
+        if( combined <= UCHAR_LATIN1_MAX )
+        {
+            for( std::size_t i = start; i < end; i++ )
+                out[i] = latin1(codePoints[i]);
+        }
+        else
+        {
+            for( std::size_t i = start; i < end; i++ )
+                out[i] = lookup(codePoints[i]);
+        }
+    }
 }
 
-bool UChar::isLower(ValueType codePoint)
+template<std::uint8_t Flag, bool (*Predicate)(UChar::ValueType)>
+static void maskBlocks(const UChar::ValueType* codePoints, std::size_t count, std::uint8_t* mask)
 {
-    if( codePoint > UCHAR_CODE_MAX )
-        return false;   
-    UCharLetter *l = findLetter(codePoint);
-    if( !l ) return false;
-    return ( l->characterCase == Case::CaseLower );
+    classifyBlocks(codePoints, count, mask,
+                   [](UChar::ValueType codePoint) { return static_cast<std::uint8_t>((UCharLatin1Flags[codePoint] & Flag) != 0); },
+                   [](UChar::ValueType codePoint) { return static_cast<std::uint8_t>(Predicate(codePoint)); });
 }
 
-bool UChar::isUpper(ValueType codePoint)
+void UChar::classify(const ValueType* codePoints, std::size_t count, std::uint8_t* categories)
 {
-    if( codePoint > UCHAR_CODE_MAX )
-        return false;   
-    UCharLetter *l = findLetter(codePoint);
-    if( !l ) return false;
-    return ( l->characterCase == Case::CaseUpper );
-}
+    // Latin-1 is the first block of the property table
+    const auto* latin1Block = &UCharPropertyStage2[UCharPropertyStage1[0] << UCHAR_PROPERTY_SHIFT];
 
-bool UChar::isTitleCase(ValueType codePoint)
-{
-    if( codePoint > UCHAR_CODE_MAX )
-        return false;   
-    UCharLetter *l = findLetter(codePoint);
-    if( !l ) return false;
-    return ( l->characterCase == Case::CaseTitle );
+    classifyBlocks(codePoints, count, categories,
+                   [latin1Block](ValueType codePoint) { return UCharProperties[latin1Block[codePoint]].category; },
+                   [](ValueType codePoint) { return static_cast<std::uint8_t>(getCategory(codePoint)); });
 }
 
-UChar UChar::toLower(ValueType codePoint)
+void UChar::isSpaceMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask)
 {
-    if( codePoint > UCHAR_CODE_MAX )
-        return UChar(codePoint);   
-    UCharLetter *l = findLetter(codePoint);
-    if( !l ) 
-        return UChar(codePoint);
-    if( l->characterCase == Case::CaseLower )
-        return UChar(codePoint);
-    return l->lowerVersion;
+    maskBlocks<UCHAR_FLAG_SPACE, &UChar::isSpace>(codePoints, count, mask);
 }
 
-UChar UChar::toUpper(ValueType codePoint)
+void UChar::isLetterMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask)
 {
-    if( codePoint > UCHAR_CODE_MAX )
-        return UChar(codePoint);   
-    UCharLetter *l = findLetter(codePoint);
-    if( !l ) 
-        return UChar(codePoint);
-    if( l->characterCase == Case::CaseUpper )
-        return UChar(codePoint);
-    return l->upperVersion;
+    maskBlocks<UCHAR_FLAG_LETTER, &UChar::isLetter>(codePoints, count, mask);
 }
 
-UChar UChar::toTitleCase(ValueType codePoint)
+void UChar::isNumberMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask)
 {
-    if( codePoint > UCHAR_CODE_MAX )
-        return UChar(codePoint);   
-    UCharLetter *l = findLetter(codePoint);
-    if( !l ) 
-        return UChar(codePoint);
-    if( l->characterCase == Case::CaseTitle )
-        return UChar(codePoint);
-    return l->titleVersion;
+    maskBlocks<UCHAR_FLAG_NUMBER, &UChar::isNumber>(codePoints, count, mask);
 }
 
-UChar::Direction UChar::getDirection(ValueType ch)
+void UChar::isPunctuationMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask)
 {
-     // Search UCharLetters
-    for( std::uint32_t i = 0; i< UCHAR_NUM_LETTERS; i++ )
-    {
-        if( UCharLetters[i].codePoint == ch )
-            return static_cast<Direction>(UCharLetters[i].direction);
-    }    
-    
-    // Search UCharNumbers
-    for( std::uint32_t i = 0; i< UCHAR_NUM_NUMBERS; i++ )
-    {
-        if( UCharNumbers[i].codePoint == ch )
-            return static_cast<Direction>(UCharNumbers[i].direction);
-    }    
-    
-    // Search UCharWhitespace
-    for( std::uint32_t i = 0; i< UCHAR_NUM_WHITESPACE; i++ )
-    {
-        if( UCharWhitespace[i].codePoint == ch )
-            return static_cast<Direction>(UCharWhitespace[i].direction);
-    }    
-    
-    // Search UCharLinebreaks
-    for( std::uint32_t i = 0; i< UCHAR_NUM_LINEBREAKS; i++ )
-    {
-        if( UCharLinebreaks[i].codePoint == ch )
-            return static_cast<Direction>(UCharLinebreaks[i].direction);
-    }    
-    // Search punctuation
-    for( std::uint32_t i = 0; i< UCHAR_NUM_PUNCTUATIONS; i++ )
-    {
-        if( UCharPunctuations[i].codePoint == ch )
-            return static_cast<Direction>(UCharPunctuations[i].direction);
-    }    
-    
-    // Search UCharSymbols
-    for( std::uint32_t i = 0; i< UCHAR_NUM_SYMBOLS; i++ )
-    {
-        if( UCharSymbols[i].codePoint == ch )
-            return static_cast<Direction>(UCharSymbols[i].direction);
-    }    
-    
-    // Search UCharMarks
-    for( std::uint32_t i = 0; i< UCHAR_NUM_MARKS; i++ )
-    {
-        if( UCharMarks[i].codePoint == ch )
-            return static_cast<Direction>(UCharMarks[i].direction);
-    }    
-    
-    // Search UCharControls 
-    for( std::uint32_t i = 0; i< UCHAR_NUM_CONTROLS; i++ )
-    {
-        if( UCharControls[i].codePoint == ch )
-            return static_cast<Direction>(UCharControls[i].direction);
-    }    
-    
-    // Search UCharControls 
-    for( std::uint32_t i = 0; i< UCHAR_NUM_SURROGATES; i++ )
-    {
-        if( UCharSurrogates[i].codePoint == ch )
-            return static_cast<Direction>(UCharSurrogates[i].direction);
-    }    
-    
-    // Search others
-    for( std::uint32_t i = 0; i< UCHAR_NUM_MARKS; i++ )
-    {
-        if( UCharOthers[i].codePoint == ch )
-            return static_cast<Direction>(UCharOthers[i].direction);
-    }    
-    
-    return DirInvalid;
+    maskBlocks<UCHAR_FLAG_PUNCTUATION, &UChar::isPunctuation>(codePoints, count, mask);
 }
 
-UChar::Category UChar::getCategory(ValueType ch)
+void UChar::isSymbolMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask)
 {
-    // TODO: Should this be replaced with something faster? Really how much
-    //       is it going to be used??
-    
-    // Search UCharLetters
-    for( std::uint32_t i = 0; i< UCHAR_NUM_LETTERS; i++ )
-    {
-        if( UCharLetters[i].codePoint == ch )
-            return static_cast<Category>(UCharLetters[i].category);
-    }    
-    
-    // Search UCharNumbers
-    for( std::uint32_t i = 0; i< UCHAR_NUM_NUMBERS; i++ )
-    {
-        if( UCharNumbers[i].codePoint == ch )
-            return static_cast<Category>(UCharNumbers[i].category);
-    }    
-    
-    // Search UCharWhitespace
-    for( std::uint32_t i = 0; i< UCHAR_NUM_WHITESPACE; i++ )
-    {
-        if( UCharWhitespace[i].codePoint == ch )
-            return static_cast<Category>(UCharWhitespace[i].category);
-    }    
-    
-    // Search UCharLinebreaks
-    for( std::uint32_t i = 0; i< UCHAR_NUM_LINEBREAKS; i++ )
-    {
-        if( UCharLinebreaks[i].codePoint == ch )
-            return static_cast<Category>(UCharLinebreaks[i].category);
-    }    
-    // Search punctuation
-    for( std::uint32_t i = 0; i< UCHAR_NUM_PUNCTUATIONS; i++ )
-    {
-        if( UCharPunctuations[i].codePoint == ch )
-            return static_cast<Category>(UCharPunctuations[i].category);
-    }    
-    
-    // Search UCharSymbols
-    for( std::uint32_t i = 0; i< UCHAR_NUM_SYMBOLS; i++ )
-    {
-        if( UCharSymbols[i].codePoint == ch )
-            return static_cast<Category>(UCharSymbols[i].category);
-    }    
-    
-    // Search UCharMarks
-    for( std::uint32_t i = 0; i< UCHAR_NUM_MARKS; i++ )
-    {
-        if( UCharMarks[i].codePoint == ch )
-            return static_cast<Category>(UCharMarks[i].category);
-    }    
-    
-    // Search UCharControls 
-    for( std::uint32_t i = 0; i< UCHAR_NUM_CONTROLS; i++ )
-    {
-        if( UCharControls[i].codePoint == ch )
-            return static_cast<Category>(UCharControls[i].category);
-    }    
-    
-    // Search UCharControls 
-    for( std::uint32_t i = 0; i< UCHAR_NUM_SURROGATES; i++ )
-    {
-        if( UCharSurrogates[i].codePoint == ch )
-            return static_cast<Category>(UCharSurrogates[i].category);
-    }    
-    
-    // Search others
-    for( std::uint32_t i = 0; i< UCHAR_NUM_MARKS; i++ )
-    {
-        if( UCharOthers[i].codePoint == ch )
-            return static_cast<Category>(UCharOthers[i].category);
-    }    
-    
-    // Really shouldn't happen
-    return CatInvalid;
+    maskBlocks<UCHAR_FLAG_SYMBOL, &UChar::isSymbol>(codePoints, count, mask);
 }
 
-UChar::Case UChar::getCase(ValueType ch)
+void UChar::isControlMask(const ValueType* codePoints, std::size_t count, std::uint8_t* mask)
 {
-    for( std::uint32_t i=0; i<UCHAR_NUM_LETTERS; i++ )
-    {
-        if( UCharLetters[i].codePoint == ch )
-            return static_cast<Case>(UCharLetters[i].characterCase);
-    }
-    
-    return CaseInvalid;
+    maskBlocks<UCHAR_FLAG_CONTROL, &UChar::isControl>(codePoints, count, mask);
 }
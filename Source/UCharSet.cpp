@@ -0,0 +1,142 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "UCharSet.h"
+#include <algorithm>
+
+UCharSet::UCharSet() USTRING_NOEXCEPT
+    : mAscii{0, 0}
+{
+}
+
+UCharSet::UCharSet(ValueType first, ValueType last)
+    : mAscii{0, 0}
+{
+    add(first, last);
+}
+
+UCharSet UCharSet::fromCategories(std::initializer_list<UChar::Category> categories)
+{
+    std::uint64_t mask = 0;
+    for( UChar::Category category : categories )
+        mask |= std::uint64_t(1) << category;
+
+    return fromPredicate([mask](ValueType codePoint) { return( ((mask >> UChar::getCategory(codePoint)) & 1) != 0 ); });
+}
+
+UCharSet UCharSet::fromRanges(std::initializer_list<std::pair<ValueType, ValueType>> ranges)
+{
+    UCharSet set;
+    for( const auto& range : ranges )
+        set.add(range.first, range.second);
+    return set;
+}
+
+UCharSet UCharSet::fromPredicate(bool (*predicate)(ValueType))
+{
+    return fromPredicate<bool (*)(ValueType)>(predicate);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Modification                                                                      ///
+/////////////////////////////////////////////////////////////////////////////////////////
+UCharSet& UCharSet::add(ValueType codePoint)
+{
+    return add(codePoint, codePoint);
+}
+
+UCharSet& UCharSet::add(ValueType first, ValueType last)
+{
+    if( first > last || first > UCHAR_CODE_MAX )
+        return *this;
+
+    UCharSet range;
+    range.mList.push_back(first);
+    range.mList.push_back(std::min<ValueType>(last, UCHAR_CODE_MAX) + 1);
+
+    return( *this = unite(range) );
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Set Operations                                                                    ///
+/////////////////////////////////////////////////////////////////////////////////////////
+
+// Walks the boundaries of both lists in order, tracking whether the current position is inside each set.
+// A boundary is written whenever the combined state changes.
+template<typename Operation>
+UCharSet UCharSet::combine(const UCharSet& other, Operation operation) const
+{
+    UCharSet    result;
+    std::size_t i = 0, j = 0;
+    bool        inResult = false;
+
+    result.mList.reserve(mList.size() + other.mList.size());
+    while( i < mList.size() || j < other.mList.size() )
+    {
+        ValueType boundary = std::min(i < mList.size() ? mList[i] : UCHAR_CODE_MAX + 1,
+                                      j < other.mList.size() ? other.mList[j] : UCHAR_CODE_MAX + 1);
+        if( i < mList.size() && mList[i] == boundary )
+            i++;
+        if( j < other.mList.size() && other.mList[j] == boundary )
+            j++;
+
+        // An odd number of boundaries passed means the position is inside the set
+        if( operation((i & 1) != 0, (j & 1) != 0) != inResult )
+        {
+            result.mList.push_back(boundary);
+            inResult = !inResult;
+        }
+    }
+
+    result.updateAscii();
+    return result;
+}
+
+UCharSet UCharSet::unite(const UCharSet& other) const
+{
+    return combine(other, [](bool inFirst, bool inSecond) { return( inFirst || inSecond ); });
+}
+
+UCharSet UCharSet::intersect(const UCharSet& other) const
+{
+    return combine(other, [](bool inFirst, bool inSecond) { return( inFirst && inSecond ); });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Membership                                                                        ///
+/////////////////////////////////////////////////////////////////////////////////////////
+bool UCharSet::containsNonAscii(ValueType codePoint) const
+{
+    // The number of boundaries at or before codePoint is odd inside the set
+    return( (std::upper_bound(mList.begin(), mList.end(), codePoint) - mList.begin()) & 1 );
+}
+
+void UCharSet::updateAscii()
+{
+    mAscii[0] = mAscii[1] = 0;
+    for( std::size_t i = 0; i < mList.size() && mList[i] < 0x80; i += 2 )
+    {
+        ValueType last = std::min<ValueType>(mList[i + 1], 0x80);
+        for( ValueType codePoint = mList[i]; codePoint < last; codePoint++ )
+            mAscii[codePoint >> 6] |= std::uint64_t(1) << (codePoint & 0x3F);
+    }
+}
@@ -0,0 +1,109 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "UStringPool.h"
+#include <cstdint>
+#include <cstring>
+
+// Strings are packed into blocks of this size, larger strings get a block of their own
+static const std::size_t BlockSize = 64 * 1024;
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// UStringPool                                                                       ///
+/////////////////////////////////////////////////////////////////////////////////////////
+
+std::size_t UStringPool::ViewHash::operator()(const UStringView& str) const
+{
+    // FNV-1a
+    std::uint64_t hash = 14695981039346656037ULL;
+    for( std::size_t i = 0; i < str.size(); i++ )
+    {
+        hash ^= static_cast<unsigned char>(str.data()[i]);
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<std::size_t>(hash);
+}
+
+const char* UStringPool::store(const char* data, std::size_t size)
+{
+    char* copy;
+    if( size + 1 > BlockSize / 4 )
+    {
+        // Keep the free space of the current block for the short strings that follow
+        mBlocks.emplace_back(new char[size + 1]);
+        copy = mBlocks.back().get();
+    }
+    else
+    {
+        if( size + 1 > mFreeSize )
+        {
+            mBlocks.emplace_back(new char[BlockSize]);
+            mFree     = mBlocks.back().get();
+            mFreeSize = BlockSize;
+        }
+        copy       = mFree;
+        mFree     += size + 1;
+        mFreeSize -= size + 1;
+    }
+
+    std::memcpy(copy, data, size);
+    copy[size] = '\0';
+    return copy;
+}
+
+UAtom UStringPool::intern(UStringView str)
+{
+    if( str.size() == 0 )
+        return UAtom();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto iter = mEntries.find(str);
+    if( iter == mEntries.end() )
+    {
+        // The length is counted once here, atoms return it without counting
+        std::size_t length = str.length();
+        iter = mEntries.insert(UStringView(store(str.data(), str.size()), str.size(), length)).first;
+    }
+    return UAtom(&*iter);
+}
+
+UAtom UStringPool::find(UStringView str) const
+{
+    if( str.size() == 0 )
+        return UAtom();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto iter = mEntries.find(str);
+    return( iter == mEntries.end() ? UAtom() : UAtom(&*iter) );
+}
+
+bool UStringPool::contains(UStringView str) const
+{
+    return( str.size() == 0 || !find(str).empty() );
+}
+
+std::size_t UStringPool::size() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEntries.size();
+}
@@ -0,0 +1,491 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "UStringRope.h"
+#include "utf8/utf8.h"
+#include <algorithm>
+#include <utility>
+
+const std::size_t UStringRope::npos;
+
+// Chunks are cut to at most this many bytes, small inserts go into an existing chunk while it stays below it
+static const std::size_t MaxChunkSize = 512;
+
+struct UStringRope::Node
+{
+    std::string     chunk;
+    std::size_t     chunkLength;    //!< Number of code-points in chunk
+    std::size_t     length;         //!< Number of code-points in this subtree
+    std::size_t     size;           //!< Number of bytes in this subtree
+    std::uint32_t   priority;       //!< Every node has a priority lower or equal to its parent
+    Node*           parent = nullptr;
+    NodePtr         left;
+    NodePtr         right;
+};
+
+// Byte offset of the idx'th code-point in a chunk
+static std::size_t chunkOffset(const std::string& chunk, std::size_t idx)
+{
+    auto iter = chunk.begin();
+    utf8::advance(iter, idx, chunk.end());
+    return( iter - chunk.begin() );
+}
+
+template<typename NodeType>
+static std::size_t lengthOf(const NodeType& node)
+{
+    return( node ? node->length : 0 );
+}
+
+template<typename NodeType>
+static std::size_t sizeOf(const NodeType& node)
+{
+    return( node ? node->size : 0 );
+}
+
+template<typename NodeType>
+static NodeType* leftmost(NodeType* node)
+{
+    while( node && node->left )
+        node = node->left.get();
+    return node;
+}
+
+template<typename NodeType>
+static NodeType* rightmost(NodeType* node)
+{
+    while( node && node->right )
+        node = node->right.get();
+    return node;
+}
+
+// Copies a subtree with the same priorities
+template<typename NodeType>
+static std::unique_ptr<NodeType> cloneTree(const NodeType* node, NodeType* parent)
+{
+    if( !node )
+        return nullptr;
+
+    std::unique_ptr<NodeType> copy(new NodeType);
+    copy->chunk         = node->chunk;
+    copy->chunkLength   = node->chunkLength;
+    copy->length        = node->length;
+    copy->size          = node->size;
+    copy->priority      = node->priority;
+    copy->parent        = parent;
+    copy->left          = cloneTree(node->left.get(), copy.get());
+    copy->right         = cloneTree(node->right.get(), copy.get());
+    return copy;
+}
+
+// Appends the bytes of the characters in [start, stop) of a subtree
+template<typename NodeType>
+static void collect(const NodeType* node, std::size_t start, std::size_t stop, std::string& bytes)
+{
+    if( !node || start >= stop )
+        return;
+
+    std::size_t chunkStart = lengthOf(node->left);
+    std::size_t chunkStop  = chunkStart + node->chunkLength;
+
+    if( start < chunkStart )
+        collect(node->left.get(), start, std::min(stop, chunkStart), bytes);
+    if( start < chunkStop && stop > chunkStart )
+    {
+        std::size_t first = chunkOffset(node->chunk, std::max(start, chunkStart) - chunkStart);
+        std::size_t last  = ( stop >= chunkStop ? node->chunk.size() : chunkOffset(node->chunk, stop - chunkStart) );
+        bytes.append(node->chunk, first, last - first);
+    }
+    if( stop > chunkStop )
+        collect(node->right.get(), std::max(start, chunkStop) - chunkStop, stop - chunkStop, bytes);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Construction                                                                      ///
+/////////////////////////////////////////////////////////////////////////////////////////
+UStringRope::UStringRope() USTRING_NOEXCEPT
+    : mSeed(2463534242u)
+{
+}
+
+UStringRope::UStringRope(const UString& str)
+    : mSeed(2463534242u)
+{
+    mRoot = build(str.toStdString());
+}
+
+UStringRope::UStringRope(const char* cstr)
+    : mSeed(2463534242u)
+{
+    if( cstr != nullptr )
+        mRoot = build(cstr);
+}
+
+UStringRope::UStringRope(const UStringRope& other)
+    : mRoot(cloneTree(other.mRoot.get(), static_cast<Node*>(nullptr))), mSeed(other.mSeed)
+{
+}
+
+UStringRope::UStringRope(UStringRope&& other) USTRING_NOEXCEPT
+    : mRoot(std::move(other.mRoot)), mSeed(other.mSeed)
+{
+}
+
+UStringRope::~UStringRope()
+{
+}
+
+UStringRope& UStringRope::operator=(const UStringRope& other)
+{
+    if( this != &other )
+    {
+        mRoot = cloneTree(other.mRoot.get(), static_cast<Node*>(nullptr));
+        mSeed = other.mSeed;
+    }
+    return *this;
+}
+
+UStringRope& UStringRope::operator=(UStringRope&& other) USTRING_NOEXCEPT
+{
+    mRoot = std::move(other.mRoot);
+    mSeed = other.mSeed;
+    return *this;
+}
+
+UStringRope::NodePtr UStringRope::makeNode(std::string bytes, std::size_t length)
+{
+    // xorshift32
+    mSeed ^= mSeed << 13;
+    mSeed ^= mSeed >> 17;
+    mSeed ^= mSeed << 5;
+
+    NodePtr node(new Node);
+    node->chunk         = std::move(bytes);
+    node->chunkLength   = length;
+    node->priority      = mSeed;
+    update(node.get());
+    return node;
+}
+
+UStringRope::NodePtr UStringRope::build(const std::string& bytes)
+{
+    NodePtr     root;
+    std::size_t start = 0;
+    while( start < bytes.size() )
+    {
+        // Move the cut back to the first byte of a character
+        std::size_t stop = std::min(start + MaxChunkSize, bytes.size());
+        while( stop < bytes.size() && stop > start + 1 && (static_cast<unsigned char>(bytes[stop]) & 0xC0) == 0x80 )
+            stop--;
+
+        std::string chunk(bytes, start, stop - start);
+        std::size_t length = UStringView::countCodePoints(chunk.data(), chunk.size());
+        root  = merge(std::move(root), makeNode(std::move(chunk), length));
+        start = stop;
+    }
+    return root;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Tree Operations                                                                   ///
+/////////////////////////////////////////////////////////////////////////////////////////
+void UStringRope::update(Node* node)
+{
+    node->length = node->chunkLength + lengthOf(node->left) + lengthOf(node->right);
+    node->size   = node->chunk.size() + sizeOf(node->left) + sizeOf(node->right);
+    if( node->left )
+        node->left->parent = node;
+    if( node->right )
+        node->right->parent = node;
+}
+
+void UStringRope::split(NodePtr node, std::size_t idx, NodePtr& left, NodePtr& right)
+{
+    if( !node )
+    {
+        left.reset();
+        right.reset();
+        return;
+    }
+
+    std::size_t chunkStart = lengthOf(node->left);
+    if( idx <= chunkStart )
+    {
+        split(std::move(node->left), idx, left, node->left);
+        update(node.get());
+        right = std::move(node);
+    }
+    else if( idx >= chunkStart + node->chunkLength )
+    {
+        split(std::move(node->right), idx - chunkStart - node->chunkLength, node->right, right);
+        update(node.get());
+        left = std::move(node);
+    }
+    else
+    {
+        // The tail of the chunk becomes a new node with the same priority, which keeps the heap order
+        std::size_t cut    = idx - chunkStart;
+        std::size_t offset = chunkOffset(node->chunk, cut);
+
+        NodePtr tail(new Node);
+        tail->chunk         = node->chunk.substr(offset);
+        tail->chunkLength   = node->chunkLength - cut;
+        tail->priority      = node->priority;
+        tail->right         = std::move(node->right);
+        update(tail.get());
+
+        node->chunk.erase(offset);
+        node->chunkLength = cut;
+        update(node.get());
+
+        left  = std::move(node);
+        right = std::move(tail);
+    }
+
+    if( left )
+        left->parent = nullptr;
+    if( right )
+        right->parent = nullptr;
+}
+
+UStringRope::NodePtr UStringRope::merge(NodePtr left, NodePtr right)
+{
+    if( !left )
+        return right;
+    if( !right )
+        return left;
+
+    if( left->priority >= right->priority )
+    {
+        left->right = merge(std::move(left->right), std::move(right));
+        update(left.get());
+        return left;
+    }
+
+    right->left = merge(std::move(left), std::move(right->left));
+    update(right.get());
+    return right;
+}
+
+UStringRope::Node* UStringRope::findNode(std::size_t& idx, bool inclusive) const
+{
+    Node* node = mRoot.get();
+    while( node )
+    {
+        std::size_t chunkStart = lengthOf(node->left);
+        std::size_t chunkStop  = chunkStart + node->chunkLength;
+        if( idx < chunkStart )
+            node = node->left.get();
+        else if( idx < chunkStop || (inclusive && idx == chunkStop) )
+        {
+            idx -= chunkStart;
+            return node;
+        }
+        else
+        {
+            idx -= chunkStop;
+            node = node->right.get();
+        }
+    }
+    return nullptr;
+}
+
+void UStringRope::adjustCounts(Node* node, std::ptrdiff_t length, std::ptrdiff_t size)
+{
+    node->chunkLength += length;
+    for( ; node; node = node->parent )
+    {
+        node->length += length;
+        node->size   += size;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Modification                                                                      ///
+/////////////////////////////////////////////////////////////////////////////////////////
+UStringRope& UStringRope::insert(const UString& what, std::size_t pos)
+{
+    const std::string& bytes = what.toStdString();
+    if( bytes.empty() )
+        return *this;
+
+    pos = std::min(pos, length());
+
+    // Small inserts go straight into the chunk holding the position while it has room
+    std::size_t idx  = pos;
+    Node*       node = ( bytes.size() < MaxChunkSize ? findNode(idx, true) : nullptr );
+    if( node && node->chunk.size() + bytes.size() <= MaxChunkSize )
+    {
+        node->chunk.insert(chunkOffset(node->chunk, idx), bytes);
+        adjustCounts(node, what.length(), bytes.size());
+        return *this;
+    }
+
+    NodePtr left, right;
+    split(std::move(mRoot), pos, left, right);
+    mRoot = merge(merge(std::move(left), build(bytes)), std::move(right));
+    return *this;
+}
+
+UStringRope& UStringRope::erase(std::size_t start, std::size_t num)
+{
+    if( start >= length() || num == 0 )
+        return *this;
+
+    num = std::min(num, length() - start);
+
+    // Erasing part of a single chunk is done in place
+    std::size_t idx  = start;
+    Node*       node = findNode(idx, false);
+    if( idx + num < node->chunkLength )
+    {
+        std::size_t first = chunkOffset(node->chunk, idx);
+        std::size_t last  = chunkOffset(node->chunk, idx + num);
+        node->chunk.erase(first, last - first);
+        adjustCounts(node, -static_cast<std::ptrdiff_t>(num), -static_cast<std::ptrdiff_t>(last - first));
+        return *this;
+    }
+
+    NodePtr left, middle, right;
+    split(std::move(mRoot), start, left, right);
+    split(std::move(right), num, middle, right);
+    mRoot = merge(std::move(left), std::move(right));
+    return *this;
+}
+
+UStringRope& UStringRope::replace(std::size_t start, std::size_t len, const UString& with)
+{
+    erase(start, len);
+    return insert(with, start);
+}
+
+UStringRope& UStringRope::clear()
+{
+    mRoot.reset();
+    return *this;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Access                                                                            ///
+/////////////////////////////////////////////////////////////////////////////////////////
+UString UStringRope::subStr(std::size_t start, std::size_t len) const
+{
+    std::size_t stop = ( len >= length() - std::min(start, length()) ? length() : start + len );
+
+    std::string bytes;
+    collect(mRoot.get(), start, stop, bytes);
+    return UString(std::move(bytes));
+}
+
+UString UStringRope::toUString() const
+{
+    std::string bytes;
+    bytes.reserve(size());
+    collect(mRoot.get(), 0, length(), bytes);
+    return UString(std::move(bytes));
+}
+
+const UChar UStringRope::at(std::size_t idx) const
+{
+    Node* node = findNode(idx, false);
+    if( !node )
+        return UCHAR_CODE_NULL;
+
+    return utf8::peek_next(node->chunk.begin() + chunkOffset(node->chunk, idx), node->chunk.end());
+}
+
+std::size_t UStringRope::length() const
+{
+    return lengthOf(mRoot);
+}
+
+std::size_t UStringRope::size() const
+{
+    return sizeOf(mRoot);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Iterator                                                                          ///
+/////////////////////////////////////////////////////////////////////////////////////////
+UStringRope::ConstIterator UStringRope::begin() const
+{
+    return ConstIterator(this, leftmost(mRoot.get()), 0);
+}
+
+UStringRope::ConstIterator& UStringRope::ConstIterator::operator++()
+{
+    auto iter = mNode->chunk.begin() + mOffset;
+    utf8::next(iter, mNode->chunk.end());
+    mOffset = iter - mNode->chunk.begin();
+
+    if( mOffset == mNode->chunk.size() )
+    {
+        // Continue with the next node in order
+        if( mNode->right )
+            mNode = leftmost(mNode->right.get());
+        else
+        {
+            const Node* child = mNode;
+            mNode = mNode->parent;
+            while( mNode && mNode->right.get() == child )
+            {
+                child = mNode;
+                mNode = mNode->parent;
+            }
+        }
+        mOffset = 0;
+    }
+    return *this;
+}
+
+UStringRope::ConstIterator& UStringRope::ConstIterator::operator--()
+{
+    if( !mNode || mOffset == 0 )
+    {
+        // Continue with the previous node in order, or the last node from the end
+        if( !mNode )
+            mNode = rightmost(mRope->mRoot.get());
+        else if( mNode->left )
+            mNode = rightmost(mNode->left.get());
+        else
+        {
+            const Node* child = mNode;
+            mNode = mNode->parent;
+            while( mNode && mNode->left.get() == child )
+            {
+                child = mNode;
+                mNode = mNode->parent;
+            }
+        }
+        mOffset = mNode->chunk.size();
+    }
+
+    auto iter = mNode->chunk.begin() + mOffset;
+    utf8::prior(iter, mNode->chunk.begin());
+    mOffset = iter - mNode->chunk.begin();
+    return *this;
+}
+
+const UChar UStringRope::ConstIterator::operator*() const
+{
+    return utf8::peek_next(mNode->chunk.begin() + mOffset, mNode->chunk.end());
+}
@@ -0,0 +1,216 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "UStringView.h"
+#include "UCharSet.h"
+#include <algorithm>
+
+const std::size_t UStringView::npos;
+
+// Byte offset of the first match of needle in haystack at or after from, UTF-8 is self-synchronizing so a byte
+// match always starts on a character boundary
+static std::size_t findBytes(const char* haystack, std::size_t size, const char* needle, std::size_t count, std::size_t from)
+{
+    if( from > size || count > size - from )
+        return UStringView::npos;
+
+    const char* found = std::search(haystack + from, haystack + size, needle, needle + count);
+    return( found != haystack + size || count == 0 ? found - haystack : UStringView::npos );
+}
+
+// Byte offset of the last match of needle in haystack ending at or before stop
+static std::size_t findLastBytes(const char* haystack, std::size_t stop, const char* needle, std::size_t count)
+{
+    if( count > stop )
+        return UStringView::npos;
+
+    const char* found = std::find_end(haystack, haystack + stop, needle, needle + count);
+    return( found != haystack + stop || count == 0 ? found - haystack : UStringView::npos );
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Size                                                                              ///
+/////////////////////////////////////////////////////////////////////////////////////////
+std::size_t UStringView::length() const
+{
+    // Threads counting at the same time store the same value
+    std::size_t length = mLength.load(std::memory_order_relaxed);
+    if( length == npos )
+    {
+        length = countCodePoints(mData, mSize);
+        mLength.store(length, std::memory_order_relaxed);
+    }
+    return length;
+}
+
+std::size_t UStringView::byteOffset(std::size_t pos) const
+{
+    if( pos >= length() )
+        return mSize;
+    if( length() == mSize )
+        return pos;
+
+    const char* iter = mData;
+    utf8::advance(iter, pos, mData + mSize);
+    return( iter - mData );
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Character Indexing                                                                ///
+/////////////////////////////////////////////////////////////////////////////////////////
+const UChar UStringView::at(std::size_t idx) const
+{
+    if( idx >= length() )
+        return UCHAR_CODE_NULL;
+
+    return utf8::peek_next(mData + byteOffset(idx), mData + mSize);
+}
+
+UStringView UStringView::subStr(std::size_t start, std::size_t len) const
+{
+    std::size_t first = std::min(start, length());
+    std::size_t last  = ( len >= length() - first ? length() : first + len );
+
+    std::size_t startByte = byteOffset(first);
+    return UStringView(mData + startByte, byteOffset(last) - startByte, last - first);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Searching                                                                         ///
+/////////////////////////////////////////////////////////////////////////////////////////
+std::size_t UStringView::find(UChar ch, std::size_t start) const
+{
+    char        bytes[4];
+    std::size_t count = utf8::append(ch, bytes) - bytes;
+    return find(UStringView(bytes, count, 1), start);
+}
+
+std::size_t UStringView::find(UStringView what, std::size_t start) const
+{
+    if( start > length() )
+        return npos;
+
+    std::size_t startByte = byteOffset(start);
+    std::size_t found     = findBytes(mData, mSize, what.mData, what.mSize, startByte);
+    if( found == npos )
+        return npos;
+
+    return start + countCodePoints(mData + startByte, found - startByte);
+}
+
+std::size_t UStringView::findLastOf(UChar ch, std::size_t pos) const
+{
+    char        bytes[4];
+    std::size_t count = utf8::append(ch, bytes) - bytes;
+    return findLastOf(UStringView(bytes, count, 1), pos);
+}
+
+std::size_t UStringView::findLastOf(UStringView what, std::size_t pos) const
+{
+    // pos counts the characters skipped from the end of the view
+    if( what.mSize == 0 || (pos != npos && pos >= length()) )
+        return npos;
+
+    std::size_t stopByte = ( pos == npos ? mSize : byteOffset(length() - pos) );
+    std::size_t found    = findLastBytes(mData, stopByte, what.mData, what.mSize);
+    if( found == npos )
+        return npos;
+
+    return countCodePoints(mData, found) + what.length() - 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Comparison                                                                        ///
+/////////////////////////////////////////////////////////////////////////////////////////
+int UStringView::compare(UStringView other) const
+{
+    int result = std::memcmp(mData, other.mData, std::min(mSize, other.mSize));
+    if( result != 0 )
+        return result;
+
+    return( mSize < other.mSize ? -1 : (mSize > other.mSize ? 1 : 0) );
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Splitting                                                                         ///
+/////////////////////////////////////////////////////////////////////////////////////////
+UStringSplitRange::Iterator::Iterator(const UStringSplitRange* range)
+    : mRange(range), mField(range->mString.data())
+{
+    findFieldEnd();
+}
+
+UStringSplitRange::Iterator& UStringSplitRange::Iterator::operator++()
+{
+    // The last field is the one that wasn't ended by a delimiter
+    if( mDelimSize == 0 )
+        mField = nullptr;
+    else
+    {
+        mField = mFieldEnd + mDelimSize;
+        findFieldEnd();
+    }
+    return *this;
+}
+
+void UStringSplitRange::Iterator::findFieldEnd()
+{
+    const char* end = mRange->mString.data() + mRange->mString.size();
+
+    if( mRange->mSplitAny )
+    {
+        // The characters are decoded anyway, so the length of the field is counted as well
+        std::size_t length = 0;
+        for( const char* iter = mField; iter != end; length++ )
+        {
+            const char*         start     = iter;
+            unsigned char       byte      = static_cast<unsigned char>(*iter);
+            UChar::ValueType    codePoint = ( byte < 0x80 ? (++iter, byte) : utf8::next(iter, end) );
+            if( mRange->mDelims.contains(codePoint) )
+            {
+                mFieldEnd       = start;
+                mFieldLength    = length;
+                mDelimSize      = iter - start;
+                return;
+            }
+        }
+        mFieldEnd       = end;
+        mFieldLength    = length;
+        mDelimSize      = 0;
+        return;
+    }
+
+    const char* delim = mRange->mDelim.data();
+    std::size_t count = mRange->mDelim.size();
+    const char* found = end;
+    if( count == 1 )
+    {
+        const void* match = std::memchr(mField, *delim, end - mField);
+        found = ( match ? static_cast<const char*>(match) : end );
+    }
+    else if( count > 1 )
+        found = std::search(mField, end, delim, delim + count);
+
+    mFieldEnd       = found;
+    mFieldLength    = UStringView::npos;
+    mDelimSize      = ( found != end ? count : 0 );
+}
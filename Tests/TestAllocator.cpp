@@ -0,0 +1,94 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "UString.h"
+#include "catch.hpp"
+#include <memory>
+#include <string>
+#include <utility>
+
+// Allocator counting the allocations made through it in a counter shared by its copies
+template<typename T>
+class CountingAllocator
+{
+    public:
+        typedef T value_type;
+
+        explicit CountingAllocator(std::size_t* counter) : mCounter(counter) { }
+        template<typename U>
+        CountingAllocator(const CountingAllocator<U>& other) : mCounter(other.mCounter) { }
+
+        T* allocate(std::size_t n)
+        {
+            (*mCounter)++;
+            return std::allocator<T>().allocate(n);
+        }
+        void deallocate(T* ptr, std::size_t n)
+        {
+            std::allocator<T>().deallocate(ptr, n);
+        }
+
+        bool operator==(const CountingAllocator& other) const { return( mCounter == other.mCounter ); }
+        bool operator!=(const CountingAllocator& other) const { return( mCounter != other.mCounter ); }
+
+        std::size_t* mCounter;
+};
+
+typedef BasicUString<CountingAllocator<char>> CountedString;
+
+TEST_CASE("Allocator", "[UString]")
+{
+    std::size_t count = 0;
+    CountingAllocator<char> alloc(&count);
+
+    // Long enough to never fit in the small string buffer
+    CountedString str(u8"ÀÉÎÕÜ àéîõü long enough to be allocated", alloc);
+    REQUIRE( count > 0 );
+    REQUIRE( str.get_allocator() == alloc );
+
+    std::size_t before = count;
+    str.toUpper();
+    REQUIRE( str == u8"ÀÉÎÕÜ ÀÉÎÕÜ LONG ENOUGH TO BE ALLOCATED" );
+    REQUIRE( count > before );
+    REQUIRE( str.get_allocator() == alloc );
+
+    REQUIRE( str.subStr(6).get_allocator() == alloc );
+    REQUIRE( str.subStr(str.find(CountedString("LONG", alloc), CountedString::Position())).get_allocator() == alloc );
+    REQUIRE( (str + CountedString("!", alloc)).get_allocator() == alloc );
+    REQUIRE( CountedString(str, alloc).get_allocator() == alloc );
+    REQUIRE( CountedString::fromStdU32String(U"ÀÉÎÕÜ", alloc).get_allocator() == alloc );
+
+    before = count;
+    str.replaceAll(CountedString(u8"ÀÉÎÕÜ", alloc), CountedString("vowels", alloc));
+    REQUIRE( str == "vowels vowels LONG ENOUGH TO BE ALLOCATED" );
+    REQUIRE( count > before );
+    REQUIRE( str.get_allocator() == alloc );
+
+    // Indexing a long non-ASCII string allocates the index with the string's allocator
+    CountedString indexed(alloc);
+    for( int i = 0; i < 100; i++ )
+        indexed.append(u8"ά");
+    before = count;
+    REQUIRE( indexed.at(90) == UChar(0x03AC) );
+    REQUIRE( count > before );
+}
@@ -22,6 +22,7 @@
 
 #include "UString.h"
 #include "catch.hpp"
+#include <utility>
 
 TEST_CASE("Assignment", "[UString]") 
 {
@@ -36,6 +37,39 @@ TEST_CASE("Assignment", "[UString]")
     REQUIRE( UString(nullptr).prepend("test") == "test" );
 }
 
+TEST_CASE("Move", "[UString]")
+{
+    UString source(u8"ά έ ή ί ΰ α test");
+    UString moved(std::move(source));
+    REQUIRE( moved == u8"ά έ ή ί ΰ α test" );
+
+    UString assigned;
+    assigned = std::move(moved);
+    REQUIRE( assigned == u8"ά έ ή ί ΰ α test" );
+    REQUIRE( UString().assign(UString("foo")) == "foo" );
+
+    std::string str(u8"έέ std::string buffer");
+    const char* buffer = str.data();
+    UString fromString(std::move(str));
+    REQUIRE( fromString == u8"έέ std::string buffer" );
+    REQUIRE( fromString.toStdString().data() == buffer );
+
+    REQUIRE( UString().append(UString("foo")) == "foo" );
+    REQUIRE( UString("foo").append(UString("bar")) == "foobar" );
+    UString appended("foo");
+    appended += UString(u8"έ");
+    REQUIRE( appended == u8"fooέ" );
+
+    UString foo("foo"), bar("bar");
+    REQUIRE( foo + bar == "foobar" );
+    REQUIRE( UString("foo") + bar == "foobar" );
+    REQUIRE( foo + UString("bar") == "foobar" );
+    REQUIRE( UString("foo") + UString("bar") == "foobar" );
+    REQUIRE( UString(u8"ά") + u8"έ" + "foo" == u8"άέfoo" );
+    REQUIRE( foo == "foo" );
+    REQUIRE( bar == "bar" );
+}
+
 TEST_CASE("Inserts", "[UString]")
 {
     REQUIRE( UString("thistest").insert(" is a ", 4) == "this is a test" );
@@ -22,6 +22,7 @@
 
 #include "UString.h"
 #include "catch.hpp"
+#include <utility>
 
 TEST_CASE("Comparison", "[UString]") 
 {
@@ -40,3 +41,48 @@ TEST_CASE("Comparison", "[UString]")
     REQUIRE( tmp.at(1) == 0x03AD );
     REQUIRE( tmp.at(8) == 'd' );
 }
+
+// The cached length has to match a fresh count of the same bytes after every modification
+static std::size_t countedLength(const UString& str)
+{
+    return UString(str.toStdString()).length();
+}
+
+TEST_CASE("Length", "[UString]")
+{
+    UString str(u8"ά έ ή");
+    REQUIRE( str.length() == 5 );
+
+    str.append(UChar(0x03AF));
+    REQUIRE( str.length() == 6 );
+    str.append(u8"ΰα");
+    REQUIRE( str.length() == 8 );
+    str.append(UString(u8"ά"));
+    REQUIRE( str.length() == countedLength(str) );
+    str.prepend(UChar('x')).prepend(u8"ή").prepend(UString("ab"));
+    REQUIRE( str.length() == countedLength(str) );
+    str.insert(u8"έέ", 3);
+    REQUIRE( str.length() == countedLength(str) );
+    str.erase(2, 3);
+    REQUIRE( str.length() == countedLength(str) );
+    str.replaceAll(u8"ά", u8"ΰΰ");
+    REQUIRE( str.length() == countedLength(str) );
+    str.replace(0, 2, "z");
+    REQUIRE( str.length() == countedLength(str) );
+    str.toUpper();
+    REQUIRE( str.length() == countedLength(str) );
+    REQUIRE( str.subStr(1, 3).length() == 3 );
+    REQUIRE( (str + str).length() == 2 * countedLength(str) );
+
+    UString copy(str);
+    REQUIRE( copy.length() == countedLength(str) );
+    UString moved(std::move(copy));
+    REQUIRE( moved.length() == countedLength(str) );
+
+    str.clear();
+    REQUIRE( str.length() == 0 );
+    str.assign(u8"ήή");
+    REQUIRE( str.length() == 2 );
+    REQUIRE( UString::fromStdU32String(U"ab\U0001F600").length() == 3 );
+    REQUIRE( UString::fromStdU16String(u"ab\U0001F600").length() == 3 );
+}
@@ -22,6 +22,8 @@
 
 #include "UString.h"
 #include "catch.hpp"
+#include <string>
+#include <utility>
 
 TEST_CASE("Encoding Conversion", "[UString]") 
 {
@@ -35,4 +37,28 @@ TEST_CASE("Case Conversion", "[UString]")
 {
     REQUIRE( UString(u8"ƵƵƵa").toLower() == u8"ƶƶƶa" );
     REQUIRE( UString(u8"abcd").toUpper() == u8"ABCD" );
-}
\ No newline at end of file
+    REQUIRE( UString(u8"ǆ中a").toTitleCase() == u8"ǅ中A" );
+    REQUIRE( UString(u8"ΆΈ中文").toLower() == u8"άέ中文" );
+}
+
+TEST_CASE("Adopt and Release", "[UString]")
+{
+    std::string buffer(u8"ά έ ή ί ΰ α, long enough for the heap");
+    const char* bytes = buffer.data();
+
+    UString str = UString::adopt(std::move(buffer), true);
+    REQUIRE( str == u8"ά έ ή ί ΰ α, long enough for the heap" );
+    REQUIRE( str.toStdString().data() == bytes );
+    REQUIRE( str.length() == 37 );
+
+    std::string released = std::move(str).release();
+    REQUIRE( released.data() == bytes );
+    REQUIRE( released == u8"ά έ ή ί ΰ α, long enough for the heap" );
+    REQUIRE( str.size() == 0 );
+    REQUIRE( str.length() == 0 );
+
+    std::string invalid("abc\xC3");
+    REQUIRE_THROWS_AS( UString::adopt(std::move(invalid), true), const utf8::invalid_utf8& );
+    REQUIRE( invalid == "abc\xC3" );
+    REQUIRE( UString::adopt(std::move(invalid)).size() == 4 );
+}
@@ -30,6 +30,9 @@ TEST_CASE("Erase Tests", "[UString]")
     REQUIRE( UString(u8"ήίΰ").erase(0) == u8"ίΰ" );
     REQUIRE( UString(u8"ήίΰ").erase(2) == u8"ήί" );
     REQUIRE( UString("blah").clear() == "" );
+    REQUIRE( UString("abcde").erase(1, 2) == "ade" );
+    REQUIRE( UString("abcde").erase(1, 2).length() == 3 );
+    REQUIRE( UString("abcde").erase(4) == "abcd" );
 
     UString tmp(u8"testingήίΰfoo");
     REQUIRE( tmp.erase(std::next(tmp.begin(), 7), std::next(tmp.begin(), 10)) == "testingfoo" );
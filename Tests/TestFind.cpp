@@ -34,4 +34,62 @@ TEST_CASE("Find Tests", "[UString]")
     REQUIRE( UString(u8"abήίΰcfooabcήίΰde").findLastOf(u8"ήίΰ", 6) == 4 );
     REQUIRE( UString("abcέdeήίΰέαa0").findLastOf(0x03AD) == 9 );
     REQUIRE( UString("abcέdeήίΰέαa0").findLastOf(0x03AD, 5) == 3 );
+
+    // Starting past the end of a non-ASCII string finds nothing
+    REQUIRE( UString(u8"ά").find("a", 2) == UString::npos );
+    REQUIRE( UString(u8"ά").find(0x03AC, 2) == UString::npos );
+    REQUIRE( UString(u8"ά").find(0x03AC, 1) == UString::npos );
+    REQUIRE( UString(u8"ά").findLastOf(u8"ά", 2) == UString::npos );
+    REQUIRE( UString(u8"ά").findLastOf(0x03AC, 5) == UString::npos );
+
+    // All-ASCII strings search the bytes directly
+    REQUIRE( UString("abcdeabcde").find('c') == 2 );
+    REQUIRE( UString("abcdeabcde").find('c', 3) == 7 );
+    REQUIRE( UString("abcdeabcde").find(0x03AD) == UString::npos );
+    REQUIRE( UString("abcdeabcde").find(u8"έ") == UString::npos );
+    REQUIRE( UString("abcdeabcde").find("cde", 3) == 7 );
+    REQUIRE( UString("abcdeabcde").findLastOf('a') == 5 );
+    REQUIRE( UString("abcdeabcde").findLastOf('a', 5) == 0 );
+    REQUIRE( UString("abcdeabcde").findLastOf('e', 10) == UString::npos );
+    REQUIRE( UString("abcfooabcde").findLastOf("ab", 3) == 7 );
+    REQUIRE( UString("abcfooabcde").findLastOf("ab", 4) == 1 );
+    REQUIRE( UString("abcfooabcde").findLastOf("abc", 9) == UString::npos );
+}
+
+TEST_CASE("Position Tests", "[UString]")
+{
+    UString str(u8"key=ήίΰ; name=value; ήίΰ=end");
+
+    UString::Position eq = str.find('=', UString::Position());
+    REQUIRE( eq.isValid() );
+    REQUIRE( str.index(eq) == 3 );
+    REQUIRE( str.subStr(UString::Position(), eq) == "key" );
+
+    UString::Position semicolon = str.find(";", eq);
+    REQUIRE( str.index(semicolon) == 7 );
+    REQUIRE( str.subStr(UString::Position(eq.byteOffset() + 1), semicolon) == u8"ήίΰ" );
+
+    UString::Position name = str.find(u8"name", semicolon);
+    REQUIRE( str.index(name) == 9 );
+    REQUIRE( str.position(9) == name );
+    REQUIRE( !str.find(u8"missing", name).isValid() );
+
+    UString::Position last = str.findLastOf(u8"ήίΰ", UString::Position(UString::npos));
+    REQUIRE( str.index(last) == 21 );
+    REQUIRE( str.index(str.findLastOf(u8"ήίΰ", last)) == 4 );
+    REQUIRE( str.index(str.findLastOf(UChar('='), last)) == 13 );
+    REQUIRE( !str.findLastOf('k', UString::Position()).isValid() );
+    REQUIRE( str.subStr(last) == u8"ήίΰ=end" );
+
+    str.replace(name, str.find(";", name), u8"ά");
+    REQUIRE( str == u8"key=ήίΰ; ά; ήίΰ=end" );
+    REQUIRE( str.length() == 19 );
+
+    str.erase(str.find(';', UString::Position()), str.find(' ', UString::Position()));
+    REQUIRE( str == u8"key=ήίΰ ά; ήίΰ=end" );
+    REQUIRE( str.length() == 18 );
+
+    str.insert(u8"ΰ", str.find(u8"ά", UString::Position()));
+    REQUIRE( str == u8"key=ήίΰ ΰά; ήίΰ=end" );
+    REQUIRE( str.length() == 19 );
 }
@@ -0,0 +1,127 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+// Built as C++17 in its own test program, the global operator new is replaced to catch any allocation that
+// bypasses the memory resource of a pmr::UString
+
+#include "SharedUString.h"
+#include "UString.h"
+#include "catch.hpp"
+#include <cstdlib>
+#include <new>
+
+#if __has_include(<memory_resource>)
+
+static std::size_t GlobalAllocations = 0;
+
+void* operator new(std::size_t size)
+{
+    GlobalAllocations++;
+    if( void* ptr = std::malloc(size == 0 ? 1 : size) )
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept                { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept   { std::free(ptr); }
+
+TEST_CASE("Memory Resource", "[UString]")
+{
+    // Running out of the buffer throws instead of falling back to the heap
+    static char buffer[256 * 1024];
+    std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    std::pmr::polymorphic_allocator<char> alloc(&resource);
+
+    std::size_t before = GlobalAllocations;
+    UChar       indexed, upper, moved;
+    std::size_t length, replaced;
+    {
+        pmr::UString str(alloc);
+        for( int i = 0; i < 500; i++ )
+            str.append(u8"ά");
+        indexed = str.at(400);
+        length  = str.length();
+
+        pmr::UString copy(str, alloc);
+        copy.toUpper();
+        upper = copy.at(450);
+
+        copy.replaceAll(pmr::UString(u8"Ά", alloc), pmr::UString("ab", alloc));
+        replaced = copy.length();
+
+        pmr::UString target(alloc);
+        target = std::move(copy);
+        moved  = target.at(999);
+        target.insert(pmr::UString(u8"ή", alloc), 10);
+        target.erase(20, 5);
+        target.subStr(100, 300).at(250);
+    }
+    std::size_t allocations = GlobalAllocations - before;
+
+    REQUIRE( allocations == 0 );
+    REQUIRE( indexed == 0x03AC );
+    REQUIRE( length == 500 );
+    REQUIRE( upper == 0x0386 );
+    REQUIRE( replaced == 1000 );
+    REQUIRE( moved == 'b' );
+}
+
+TEST_CASE("Shared Memory Resource", "[SharedUString]")
+{
+    static char buffer[64 * 1024];
+    std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    std::pmr::polymorphic_allocator<char> alloc(&resource);
+    typedef BasicSharedUString<std::pmr::polymorphic_allocator<char>> PmrSharedUString;
+
+    std::size_t before = GlobalAllocations;
+    bool emptyInArena, copyInArena, movedInArena, detachedInArena, shared, original;
+    {
+        PmrSharedUString empty(alloc);
+        emptyInArena = ( empty.get().get_allocator().resource() == &resource );
+
+        pmr::UString str(u8"Ελλάδα", alloc);
+        PmrSharedUString copied(str);
+        copyInArena = ( copied.get().get_allocator().resource() == &resource );
+
+        PmrSharedUString moved(std::move(str));
+        movedInArena = ( moved.get().get_allocator().resource() == &resource );
+
+        // Appending to a shared copy detaches it into a new buffer from the same resource
+        PmrSharedUString copy = copied;
+        shared = copy.isShared();
+        copy.append(u8"ά");
+        detachedInArena = ( copy.get().get_allocator().resource() == &resource );
+        original = ( copied.get() == pmr::UString(u8"Ελλάδα", alloc) && copy->length() == 7 && !copy.isShared() );
+    }
+    std::size_t allocations = GlobalAllocations - before;
+
+    REQUIRE( allocations == 0 );
+    REQUIRE( emptyInArena );
+    REQUIRE( copyInArena );
+    REQUIRE( movedInArena );
+    REQUIRE( shared );
+    REQUIRE( detachedInArena );
+    REQUIRE( original );
+}
+
+#endif
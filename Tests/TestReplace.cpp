@@ -33,4 +33,60 @@ TEST_CASE("Replacement Tests", "[UString]")
     REQUIRE( UString(u8"ήίΰ ήίΰ ήίΰ").replaceFirst(u8"ήίΰ", u8"foo", 4) == u8"ήίΰ foo ήίΰ" );
     REQUIRE( UString(u8"ήίΰ ήίΰ ήίΰ").replaceLast(u8"ήίΰ", u8"foo") == u8"ήίΰ ήίΰ foo" );
     REQUIRE( UString(u8"ήίΰ ήίΰ ήίΰ").replaceLast(u8"ήίΰ", u8"foo", 7) == u8"ήίΰ foo ήίΰ" );
+    REQUIRE( UString("foo bar foo").replaceLast("foo", "baz") == "foo bar baz" );
+    REQUIRE( UString("foo bar foo").replaceLast("foo", "baz", 4) == "baz bar foo" );
+    REQUIRE( UString("foo bar").replace(4, 3, u8"ήίΰ") == u8"foo ήίΰ" );
+    REQUIRE( UString("foo bar").replace(4, 3, u8"ήίΰ").length() == 7 );
+    REQUIRE( UString("foo bar").replace(4, 3, u8"ήίΰ").find(0x03AF) == 5 );
+    REQUIRE( UString("foo bar").replaceAll("", "baz") == "foo bar" );
+    REQUIRE( UString("foo bar").replaceAll("foo", "baz", 20) == "foo bar" );
+    REQUIRE( UString(u8"ήίΰ ήίΰ ήίΰ").replaceAll(u8"ήίΰ", u8"ά").length() == 5 );
+    REQUIRE( UString("aaaa").replaceAll("aa", "a") == "aa" );
+}
+
+TEST_CASE("Repeated Replacement", "[UString]")
+{
+    // Long enough to need the heap, the scratch buffer is reused between edits
+    UString str;
+    for( int i = 0; i < 50; i++ )
+        str.append(u8"άέή foo ");
+
+    for( int i = 0; i < 10; i++ )
+    {
+        str.replaceAll(u8"άέή", "bar").toUpper();
+        REQUIRE( str.find(u8"ΆΈΉ") == UString::npos );
+        REQUIRE( str.length() == 400 );
+        str.replaceAll("BAR", u8"άέή").toLower();
+        REQUIRE( str.subStr(0, 8) == u8"άέή foo " );
+        REQUIRE( str.length() == 400 );
+    }
+
+    UString upper(str);
+    REQUIRE( upper.toUpper().subStr(392) == u8"ΆΈΉ FOO " );
+    REQUIRE( str.subStr(392) == u8"άέή foo " );
+}
+
+TEST_CASE("Self Replacement", "[UString]")
+{
+    // The replacement is the string being changed
+    UString str(u8"héllo");
+    str.replace(0, 1, str);
+    REQUIRE( str == u8"hélloéllo" );
+    REQUIRE( str.length() == 9 );
+
+    UString longStr(u8"ά έ ή ί ΰ α β γ δ ε ζ η θ ι κ λ μ");
+    longStr.replace(2, 30, longStr);
+    REQUIRE( longStr == u8"ά ά έ ή ί ΰ α β γ δ ε ζ η θ ι κ λ μμ" );
+    REQUIRE( longStr.length() == 36 );
+
+    UString posStr(u8"héllo");
+    posStr.replace(posStr.position(0), posStr.position(1), posStr);
+    REQUIRE( posStr == u8"hélloéllo" );
+    REQUIRE( posStr.length() == 9 );
+
+    UString wide(u8"ά έ ή ί ΰ α β γ δ ε ζ η θ ι κ λ μ");
+    REQUIRE( wide.length() == 33 );
+    wide.replace(wide.find(u8"β", UString::Position()), wide.find(u8"ι", UString::Position()), wide);
+    REQUIRE( wide == u8"ά έ ή ί ΰ α ά έ ή ί ΰ α β γ δ ε ζ η θ ι κ λ μι κ λ μ" );
+    REQUIRE( wide.length() == 52 );
 }
@@ -0,0 +1,92 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "SharedUString.h"
+#include "catch.hpp"
+#include <thread>
+#include <vector>
+
+TEST_CASE("Shared Strings", "[SharedUString]")
+{
+    SharedUString str(u8"ά έ ή ί ΰ α shared");
+    SharedUString copy(str);
+
+    REQUIRE( copy.isShared() );
+    REQUIRE( &copy.get() == &str.get() );
+    REQUIRE( copy == str );
+    REQUIRE( copy->length() == 18 );
+    REQUIRE( copy->find(u8"ΰ") == 8 );
+
+    // Writing to one copy detaches it and leaves the others alone
+    copy.append(" copy").toUpper();
+    REQUIRE( !copy.isShared() );
+    REQUIRE( !str.isShared() );
+    REQUIRE( copy.get() == u8"Ά Έ Ή Ί ΰ Α SHARED COPY" );
+    REQUIRE( str.get() == u8"ά έ ή ί ΰ α shared" );
+    REQUIRE( copy != str );
+
+    // A string that is not shared is modified in place
+    const UString* buffer = &copy.get();
+    copy.replaceAll(" COPY", "").erase(0, 2);
+    REQUIRE( &copy.get() == buffer );
+    REQUIRE( copy.get() == u8"Έ Ή Ί ΰ Α SHARED" );
+
+    SharedUString assigned;
+    REQUIRE( assigned->length() == 0 );
+    assigned = str;
+    REQUIRE( assigned.isShared() );
+    assigned = "foo";
+    REQUIRE( !str.isShared() );
+    REQUIRE( assigned.get() == "foo" );
+
+    UString plain(u8"άέή");
+    SharedUString fromString(plain);
+    fromString.prepend("foo").insert(u8"ί", 3);
+    REQUIRE( fromString.get() == u8"fooίάέή" );
+    REQUIRE( plain == u8"άέή" );
+}
+
+TEST_CASE("Shared Strings Across Threads", "[SharedUString]")
+{
+    UString text;
+    for( int i = 0; i < 200; i++ )
+        text.append(u8"ά έ ή ");
+    SharedUString str(std::move(text));
+
+    // Every thread reads its own copy of the same buffer
+    std::vector<std::thread> threads;
+    std::vector<int> matches(4, 0);
+    for( int t = 0; t < 4; t++ )
+    {
+        threads.emplace_back([&matches, t](SharedUString copy)
+        {
+            for( std::size_t i = 0; i < copy->length(); i++ )
+                matches[t] += ( copy->at(i) == UChar(0x03AD) );
+        }, str);
+    }
+    for( auto& thread : threads )
+        thread.join();
+
+    for( int count : matches )
+        REQUIRE( count == 200 );
+}
@@ -22,10 +22,98 @@
 
 #include "UString.h"
 #include "catch.hpp"
+#include <thread>
+#include <vector>
 
 TEST_CASE("Substring Tests", "[UString]") 
 {
     REQUIRE( UString("abcde").subStr(0, 3) == "abc" );
     REQUIRE( UString("abcde").subStr(2, 2) == "cd" );
     REQUIRE( UString(u8"άέήίΰαa0djk").subStr(2, 6) == u8"ήίΰαa0" );
-}
\ No newline at end of file
+    REQUIRE( UString("abcde").subStr(2) == "cde" );
+    REQUIRE( UString("abcde").subStr(5) == "" );
+    REQUIRE( UString("abcde").at(4) == 'e' );
+    REQUIRE( UString("abcde").at(5) == UCHAR_CODE_NULL );
+    REQUIRE( UString(u8"abcdé").at(4) == 0xE9 );
+}
+
+TEST_CASE("Long String Indexing", "[UString]")
+{
+    // Long enough that positions are looked up through the sparse byte index
+    std::u32string chars;
+    for( char32_t ch = 0; ch < 300; ch++ )
+        chars.push_back(ch % 3 == 0 ? U'a' + ch % 26 : ch % 3 == 1 ? 0x03AC + ch % 20 : 0x4E00 + ch);
+
+    UString str = UString::fromStdU32String(chars);
+    for( std::size_t i = 0; i < chars.size(); i++ )
+        REQUIRE( str.at(i) == UChar(chars[i]) );
+    REQUIRE( str.at(chars.size()) == UCHAR_CODE_NULL );
+
+    REQUIRE( str.subStr(200, 5) == UString::fromStdU32String(chars.substr(200, 5)) );
+    REQUIRE( str.subStr(290) == UString::fromStdU32String(chars.substr(290)) );
+    REQUIRE( str.subStr(290, 50).length() == 10 );
+
+    // Appending keeps the existing index entries valid
+    str.append(u8"ήίΰ");
+    chars.append(U"ήίΰ");
+    REQUIRE( str.at(301) == UChar(chars[301]) );
+    REQUIRE( str.at(150) == UChar(chars[150]) );
+
+    str.erase(100, 30);
+    chars.erase(100, 30);
+    REQUIRE( str == UString::fromStdU32String(chars) );
+    REQUIRE( str.at(200) == UChar(chars[200]) );
+
+    str.replace(70, 2, u8"έέέέ");
+    chars.replace(70, 2, U"έέέέ");
+    REQUIRE( str == UString::fromStdU32String(chars) );
+    REQUIRE( str.length() == chars.size() );
+    REQUIRE( str.at(250) == UChar(chars[250]) );
+
+    str.insert(u8"中", 65);
+    chars.insert(65, U"中");
+    REQUIRE( str == UString::fromStdU32String(chars) );
+    REQUIRE( str.at(65) == 0x4E2D );
+    REQUIRE( str.at(260) == UChar(chars[260]) );
+}
+
+TEST_CASE("Concurrent Indexing", "[UString]")
+{
+    std::u32string chars;
+    for( char32_t ch = 0; ch < 5000; ch++ )
+        chars.push_back(ch % 2 == 0 ? 0x03AC + ch % 20 : 0x4E00 + ch);
+
+    // The length and index of a shared const string are built by whichever thread reads it first
+    for( int round = 0; round < 20; round++ )
+    {
+        const UString str(UString::fromStdU32String(chars).toStdString());
+        std::vector<int> mismatches(4, 0);
+        std::vector<std::thread> threads;
+        for( std::size_t t = 0; t < mismatches.size(); t++ )
+        {
+            threads.emplace_back([&str, &chars, &mismatches, t]()
+            {
+                for( std::size_t i = t; i < chars.size(); i += 97 )
+                    mismatches[t] += ( str.at(i) != UChar(chars[i]) );
+                mismatches[t] += ( str.length() != chars.size() );
+                mismatches[t] += ( str.index(str.position(4321)) != 4321 );
+            });
+        }
+        for( auto& thread : threads )
+            thread.join();
+
+        REQUIRE( mismatches == std::vector<int>(mismatches.size(), 0) );
+    }
+
+    // Appending to an indexed string extends the index
+    UString str = UString::fromStdU32String(chars);
+    REQUIRE( str.at(4999) == UChar(chars[4999]) );
+    for( int i = 0; i < 300; i++ )
+    {
+        str.append(UChar(0x03AC + i % 20));
+        chars.push_back(0x03AC + i % 20);
+        REQUIRE( str.at(chars.size() - 1) == UChar(chars.back()) );
+    }
+    REQUIRE( str.at(5150) == UChar(chars[5150]) );
+    REQUIRE( str.index(str.position(5250)) == 5250 );
+}
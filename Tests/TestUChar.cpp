@@ -22,6 +22,7 @@
 
 #include "UChar.h"
 #include "catch.hpp"
+#include <vector>
 
 TEST_CASE("UChar Tests", "[UChar]") 
 {
@@ -29,11 +30,22 @@ TEST_CASE("UChar Tests", "[UChar]")
     REQUIRE( UChar::getCategory('A') == UChar::Category::LetterUppercase );
     REQUIRE( UChar::getCategory(0x311F) == UChar::Category::LetterOther );
     REQUIRE( UChar::getCategory(0xFB29) == UChar::Category::SymbolMath );
+    REQUIRE( UChar::getCategory(0x0378) == UChar::Category::OtherNotAssigned );
+    REQUIRE( UChar::getCategory(0x110000) == UChar::Category::CatInvalid );
+    REQUIRE( UChar::getDirection('a') == UChar::Direction::DirL );
+    REQUIRE( UChar::getDirection(0x05D0) == UChar::Direction::DirR );
+    REQUIRE( UChar::getDirection(0x0627) == UChar::Direction::DirAL );
+    REQUIRE( UChar::getDirection(0x0378) == UChar::Direction::DirL );
     REQUIRE( UChar::toUpper(0x1042F) == 0x10407 );
     REQUIRE( UChar().assign('F') == 'F' );
     REQUIRE( UChar('z').toUpper() == 'Z' );
     REQUIRE( UChar('L').toLower() == 'l' );
     REQUIRE( UChar('3').toUpper() == '3' );
+    REQUIRE( UChar::toLower(0x4E2D) == 0x4E2D );
+    REQUIRE( UChar::toTitleCase('a') == 'A' );
+    REQUIRE( UChar::toTitleCase('A') == 'A' );
+    REQUIRE( UChar::toTitleCase(0x01C6) == 0x01C5 );
+    REQUIRE( UChar::toLower(0x2160) == 0x2170 );
     REQUIRE( UChar::isNull(UCHAR_CODE_NULL) );
     REQUIRE( UChar(' ').isSpace() );
     REQUIRE( UChar::isSpace(0x1680) );
@@ -48,5 +60,80 @@ TEST_CASE("UChar Tests", "[UChar]")
     REQUIRE( UChar::isSymbol('$') );
     REQUIRE( UChar::isNumber('9') );
     REQUIRE( UChar::isNumber(0x3007) );
+    REQUIRE( UChar::isLetter(0xE9) );
+    REQUIRE( UChar::isSpace(0x85) );
+    REQUIRE( UChar::isSpace(0xA0) );
+    REQUIRE( !UChar::isSpace(0x2028) );
+    REQUIRE( UChar::isLineBreak(0x2028) );
+    REQUIRE( UChar::isSymbol(0xA9) );
+    REQUIRE( UChar::isNumber(0xB2) );
+    REQUIRE( UChar::isControl(0xAD) );
+    REQUIRE( UChar::isPunctuation(0xBF) );
+    REQUIRE( UChar::isUpper(0xC9) );
+    REQUIRE( UChar::isLower(0xDF) );
+    REQUIRE( !UChar::isLetter(0x110000) );
     REQUIRE( UChar::getCase(0x2C09) == UChar::Case::CaseUpper );
+    REQUIRE( UChar::getCase(0x311F) == UChar::Case::CaseNone );
+    REQUIRE( UChar::getCase('3') == UChar::Case::CaseInvalid );
+    REQUIRE( UChar::isTitleCase(0x01C5) );
+    REQUIRE( UChar::getCategory(0x4E2D) == UChar::Category::LetterOther );
+    REQUIRE( UChar::getCategory(0xAC01) == UChar::Category::LetterOther );
+    REQUIRE( UChar::getCategory(0x20001) == UChar::Category::LetterOther );
+    REQUIRE( UChar::getCategory(0xE123) == UChar::Category::OtherPrivateUse );
+    REQUIRE( UChar::getCategory(0x1F600) == UChar::Category::SymbolOther );
+    REQUIRE( UChar::getCategory(0x10FFFD) == UChar::Category::OtherPrivateUse );
+    REQUIRE( UChar::getDirection(0x20001) == UChar::Direction::DirL );
+    REQUIRE( UChar::getCase(0x4E2D) == UChar::Case::CaseNone );
+    REQUIRE( UChar::isSurrogate(0xD900) );
+    REQUIRE( UChar::toLower(0x1E900) == 0x1E922 );
+    REQUIRE( UChar::toUpper(0x110000) == 0x110000 );
+    REQUIRE( UChar::getDirection(0x110000) == UChar::Direction::DirInvalid );
+    REQUIRE( UChar::getCase(0x110000) == UChar::Case::CaseInvalid );
+
+    UChar::Properties props = UChar(0x0394).properties();
+    REQUIRE( props.category() == UChar::Category::LetterUppercase );
+    REQUIRE( props.direction() == UChar::Direction::DirL );
+    REQUIRE( props.characterCase() == UChar::Case::CaseUpper );
+    REQUIRE( props.toLower() == 0x03B4 );
+    REQUIRE( props.toUpper() == 0x0394 );
+    REQUIRE( UChar::properties(0x01C4).toTitleCase() == 0x01C5 );
+    REQUIRE( UChar::properties(0x0661).direction() == UChar::Direction::DirAN );
+    REQUIRE( UChar::properties(0x110000).category() == UChar::Category::CatInvalid );
+}
+
+TEST_CASE("UChar Bulk Tests", "[UChar]")
+{
+    // Mixes Latin-1 only blocks with blocks that need the full lookup, and ends with a partial block
+    std::vector<UChar::ValueType> codePoints;
+    for( UChar::ValueType codePoint = 0; codePoint < 0x300; codePoint++ )
+        codePoints.push_back(codePoint);
+    for( UChar::ValueType codePoint : { 0x1680, 0x3000, 0x4E2D, 0x1F600, 0x10FFFF, 0x110000, 0x20 } )
+        codePoints.push_back(codePoint);
+
+    std::vector<std::uint8_t> out(codePoints.size());
+
+    UChar::classify(codePoints.data(), codePoints.size(), out.data());
+    for( std::size_t i = 0; i < codePoints.size(); i++ )
+        REQUIRE( out[i] == UChar::getCategory(codePoints[i]) );
+
+    UChar::isSpaceMask(codePoints.data(), codePoints.size(), out.data());
+    for( std::size_t i = 0; i < codePoints.size(); i++ )
+        REQUIRE( out[i] == UChar::isSpace(codePoints[i]) );
+
+    UChar::isLetterMask(codePoints.data(), codePoints.size(), out.data());
+    for( std::size_t i = 0; i < codePoints.size(); i++ )
+        REQUIRE( out[i] == UChar::isLetter(codePoints[i]) );
+
+    UChar::isPunctuationMask(codePoints.data(), codePoints.size(), out.data());
+    for( std::size_t i = 0; i < codePoints.size(); i++ )
+        REQUIRE( out[i] == UChar::isPunctuation(codePoints[i]) );
 }
+
+#if defined(USTRING_CONSTEXPR_TABLES) && defined(HAVE_CONSTEXPR)
+    static_assert( UChar::isSpace(0x20), "isSpace should be evaluated at compile-time" );
+    static_assert( UChar::isLetter(0x2C09), "isLetter should be evaluated at compile-time" );
+    static_assert( UChar::getCategory('A') == UChar::Category::LetterUppercase, "getCategory should be evaluated at compile-time" );
+    static_assert( UChar::toUpper('z') == 'Z', "toUpper should be evaluated at compile-time" );
+    static_assert( UChar::toUpper(0x1042F) == 0x10407, "Supplementary lookups should be evaluated at compile-time" );
+    static_assert( UChar::properties(0x0394).toLower() == 0x03B4, "properties should be evaluated at compile-time" );
+#endif
@@ -0,0 +1,89 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "UCharSet.h"
+#include "catch.hpp"
+
+TEST_CASE("UCharSet Tests", "[UCharSet]")
+{
+    UCharSet empty;
+    REQUIRE( empty.isEmpty() );
+    REQUIRE( !empty.contains('a') );
+    REQUIRE( !empty.contains(0x4E2D) );
+
+    UCharSet hex = UCharSet::fromRanges({ {'0', '9'}, {'a', 'f'}, {'A', 'F'} });
+    REQUIRE( hex.rangeCount() == 3 );
+    REQUIRE( hex.contains('0') );
+    REQUIRE( hex.contains('9') );
+    REQUIRE( hex.contains('f') );
+    REQUIRE( hex.contains(UChar('C')) );
+    REQUIRE( !hex.contains('g') );
+    REQUIRE( !hex.contains(0xFF10) );
+
+    // Overlapping and adjacent ranges are merged
+    UCharSet merged = UCharSet::fromRanges({ {0x400, 0x4FF}, {0x300, 0x3FF}, {0x450, 0x520} });
+    REQUIRE( merged.rangeCount() == 1 );
+    REQUIRE( merged.contains(0x300) );
+    REQUIRE( merged.contains(0x520) );
+    REQUIRE( !merged.contains(0x521) );
+    REQUIRE( !merged.contains(0x2FF) );
+
+    UCharSet set = UCharSet::fromCategories({ UChar::LetterUppercase, UChar::NumberDecimalDigit });
+    REQUIRE( set.contains('A') );
+    REQUIRE( set.contains('7') );
+    REQUIRE( set.contains(0x0394) );
+    REQUIRE( set.contains(0x0661) );
+    REQUIRE( !set.contains('a') );
+    REQUIRE( !set.contains(0x4E2D) );
+    REQUIRE( !set.contains(0x110000) );
+
+    UCharSet spaces = UCharSet::fromPredicate(UChar::isSpace);
+    REQUIRE( spaces.contains(' ') );
+    REQUIRE( spaces.contains('\t') );
+    REQUIRE( spaces.contains(0x3000) );
+    REQUIRE( !spaces.contains('x') );
+
+    UCharSet privateUse = UCharSet::fromPredicate([](UChar::ValueType codePoint) { return codePoint >= 0x100000; });
+    REQUIRE( privateUse.rangeCount() == 1 );
+    REQUIRE( privateUse.contains(UCHAR_CODE_MAX) );
+    REQUIRE( !privateUse.contains(UCHAR_CODE_MAX + 1) );
+
+    UCharSet delimiters = spaces | UCharSet::fromRanges({ {',', ','}, {';', ';'} });
+    REQUIRE( delimiters.contains(',') );
+    REQUIRE( delimiters.contains(';') );
+    REQUIRE( delimiters.contains(0x2003) );
+    REQUIRE( !delimiters.contains('.') );
+
+    UCharSet upperHex = hex & set;
+    REQUIRE( upperHex == UCharSet::fromRanges({ {'0', '9'}, {'A', 'F'} }) );
+    REQUIRE( (hex & UCharSet(0x4E00, 0x9FFF)).isEmpty() );
+
+    UCharSet grow('a', 'c');
+    grow.add('d').add(0x1F600);
+    grow |= UCharSet('x', 'z');
+    REQUIRE( grow.rangeCount() == 3 );
+    REQUIRE( grow.contains('d') );
+    REQUIRE( grow.contains(0x1F600) );
+    REQUIRE( !grow.contains(0x1F601) );
+    grow &= UCharSet('b', 'y');
+    REQUIRE( grow == UCharSet::fromRanges({ {'b', 'd'}, {'x', 'y'} }) );
+}
@@ -0,0 +1,133 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "UStringPool.h"
+#include "catch.hpp"
+#include <map>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("Interning", "[UStringPool]")
+{
+    UStringPool pool;
+    UString     name(u8"Ελλάδα");
+
+    UAtom atom = pool.intern(name);
+    REQUIRE( atom == pool.intern(u8"Ελλάδα") );
+    REQUIRE( atom == pool.intern(UStringView(u8"Ελλάδα")) );
+    REQUIRE( atom.view().data() == pool.intern(name).view().data() );
+    REQUIRE( atom.view().data() != name.toStdString().data() );
+    REQUIRE( atom != pool.intern(u8"España") );
+    REQUIRE( pool.size() == 2 );
+
+    REQUIRE( atom.view() == u8"Ελλάδα" );
+    REQUIRE( atom == UStringView(u8"Ελλάδα") );
+    REQUIRE( atom.length() == 6 );
+    REQUIRE( atom.size() == 12 );
+    REQUIRE( atom.toUString() == name );
+    REQUIRE( atom.hash() == pool.intern(name).hash() );
+    REQUIRE( std::hash<UAtom>()(atom) == atom.hash() );
+
+    std::ostringstream os;
+    os << atom;
+    REQUIRE( os.str() == u8"Ελλάδα" );
+
+    // The empty string is the default atom
+    REQUIRE( UAtom().empty() );
+    REQUIRE( UAtom().view() == "" );
+    REQUIRE( pool.intern("") == UAtom() );
+    REQUIRE( pool.size() == 2 );
+
+    REQUIRE( pool.find(u8"España") == pool.intern(u8"España") );
+    REQUIRE( pool.find("missing").empty() );
+    REQUIRE( pool.contains(u8"España") );
+    REQUIRE( pool.contains("") );
+    REQUIRE_FALSE( pool.contains("missing") );
+    REQUIRE( pool.size() == 2 );
+
+    // Atoms of different pools are different
+    UStringPool other;
+    REQUIRE( other.intern(name) != atom );
+    REQUIRE( other.intern(name).view() == atom.view() );
+
+    // Long strings do not share a block but are interned the same way
+    UString longStr;
+    for( int i = 0; i < 10000; i++ )
+        longStr += u8"ά";
+    UAtom longAtom = pool.intern(longStr);
+    REQUIRE( longAtom.length() == 10000 );
+    REQUIRE( longAtom == pool.intern(longStr) );
+    REQUIRE( pool.intern(u8"Ελλάδα") == atom );
+
+    // Atoms stay valid while the table grows
+    for( int i = 0; i < 20000; i++ )
+        pool.intern(std::to_string(i).c_str());
+    REQUIRE( pool.size() == 20003 );
+    REQUIRE( atom.view() == u8"Ελλάδα" );
+    REQUIRE( pool.intern("12345").view() == "12345" );
+}
+
+TEST_CASE("Atoms As Keys", "[UStringPool]")
+{
+    UStringPool pool;
+    std::map<UAtom, int>            ordered;
+    std::unordered_map<UAtom, int>  hashed;
+
+    const char* tags[] = { "red", "green", u8"röd", "red", u8"grön", "green", "red" };
+    for( const char* tag : tags )
+    {
+        ordered[pool.intern(tag)]++;
+        hashed[pool.intern(tag)]++;
+    }
+
+    REQUIRE( ordered.size() == 4 );
+    REQUIRE( hashed.size() == 4 );
+    REQUIRE( ordered[pool.intern("red")] == 3 );
+    REQUIRE( hashed[pool.intern("green")] == 2 );
+    REQUIRE( hashed[pool.intern(u8"röd")] == 1 );
+}
+
+TEST_CASE("Concurrent Interning", "[UStringPool]")
+{
+    UStringPool pool;
+    std::vector<std::vector<UAtom>> results(4);
+    std::vector<std::thread> threads;
+
+    for( std::size_t t = 0; t < results.size(); t++ )
+    {
+        threads.emplace_back([&pool, &results, t]()
+        {
+            for( int i = 0; i < 2000; i++ )
+                results[t].push_back(pool.intern((u8"tag-ü-" + std::to_string(i % 500)).c_str()));
+        });
+    }
+    for( auto& thread : threads )
+        thread.join();
+
+    REQUIRE( pool.size() == 500 );
+    for( std::size_t t = 1; t < results.size(); t++ )
+        REQUIRE( results[t] == results[0] );
+    REQUIRE( results[0][0].length() == 7 );
+}
@@ -0,0 +1,104 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "UStringRope.h"
+#include "catch.hpp"
+#include <iterator>
+#include <vector>
+
+TEST_CASE("Rope", "[UStringRope]")
+{
+    UStringRope rope(u8"ά έ ή ί ΰ α");
+    REQUIRE( rope.length() == 11 );
+    REQUIRE( rope.size() == 17 );
+    REQUIRE( rope.at(2) == UChar(0x03AD) );
+    REQUIRE( rope.at(11) == UCHAR_CODE_NULL );
+
+    rope.insert("foo ", 4).append(" bar").prepend(u8"ƶ ");
+    REQUIRE( rope.toUString() == u8"ƶ ά έ foo ή ί ΰ α bar" );
+    REQUIRE( rope.subStr(6, 3) == "foo" );
+    REQUIRE( rope.subStr(18) == "bar" );
+    REQUIRE( rope.subStr(30).length() == 0 );
+
+    rope.erase(6, 4).replace(0, 2, "x");
+    REQUIRE( rope.toUString() == u8"xά έ ή ί ΰ α bar" );
+    REQUIRE( rope.erase(12, 20).toUString() == u8"xά έ ή ί ΰ α" );
+
+    UStringRope copy(rope);
+    copy.clear();
+    REQUIRE( copy.length() == 0 );
+    REQUIRE( copy.begin() == copy.end() );
+    REQUIRE( rope.length() == 12 );
+
+    std::vector<UChar> forward(rope.begin(), rope.end());
+    REQUIRE( forward.size() == 12 );
+    REQUIRE( forward[1] == UChar(0x03AC) );
+    auto last = rope.end();
+    --last;
+    REQUIRE( *last == UChar(0x03B1) );
+}
+
+TEST_CASE("Rope Editing", "[UStringRope]")
+{
+    // Edit a rope spanning many chunks and check it against the same edits on a UString
+    UString text;
+    for( int i = 0; i < 500; i++ )
+        text.append(u8"άέή foo ΰ bar ");
+    UStringRope rope(text);
+    REQUIRE( rope.toUString() == text );
+
+    std::size_t pos = 3;
+    for( int i = 0; i < 300; i++ )
+    {
+        pos = (pos * 7919 + 13) % text.length();
+        switch( i % 4 )
+        {
+            case 0: rope.insert(u8"ί", pos);      text.insert(u8"ί", pos);        break;
+            case 1: rope.erase(pos, 3);             text.erase(pos, 3);             break;
+            case 2: rope.replace(pos, 2, "xyz");    text.replace(pos, 2, "xyz");    break;
+            case 3: rope.insert(text.subStr(0, 700), pos); text.insert(text.subStr(0, 700), pos); break;
+        }
+        REQUIRE( rope.length() == text.length() );
+        REQUIRE( rope.at(pos) == text.at(pos) );
+    }
+
+    REQUIRE( rope.size() == text.size() );
+    REQUIRE( rope.toUString() == text );
+    REQUIRE( rope.subStr(1234, 999) == text.subStr(1234, 999) );
+
+    std::size_t count = 0;
+    auto expected = text.begin();
+    for( UChar ch : rope )
+    {
+        if( ch != *expected )
+            break;
+        ++expected;
+        count++;
+    }
+    REQUIRE( count == text.length() );
+
+    count = 0;
+    for( auto iter = rope.end(); iter != rope.begin(); count++ )
+        --iter;
+    REQUIRE( count == text.length() );
+}
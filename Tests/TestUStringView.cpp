@@ -0,0 +1,225 @@
+//   UString - UTF-8 C++ Library
+//     Copyright (c) 2016, 2017 Jeremy Harmon <jeremy.harmon@zoho.com>
+//     http://github.com/zordtk/ustring
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "UString.h"
+#include "UCharSet.h"
+#include "catch.hpp"
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static std::size_t countSpaces(UStringView view)
+{
+    std::size_t count = 0;
+    for( UChar ch : view )
+        count += ch.isSpace();
+    return count;
+}
+
+template<typename T>
+static auto canSplit(int) -> decltype(std::declval<T>().split(","), std::declval<T>().splitAny(UCharSet()), true)
+{
+    return true;
+}
+template<typename T>
+static bool canSplit(...)
+{
+    return false;
+}
+
+TEST_CASE("View", "[UStringView]")
+{
+    UString     str(u8"ά έ ή ί ΰ α test");
+    UStringView view(str);
+    REQUIRE( view.data() == str.toStdString().data() );
+    REQUIRE( view.size() == str.size() );
+    REQUIRE( view.length() == 16 );
+    REQUIRE( view == str );
+    REQUIRE( view == u8"ά έ ή ί ΰ α test" );
+    REQUIRE( view.at(2) == UChar(0x03AD) );
+    REQUIRE( view[40] == UCHAR_CODE_NULL );
+
+    // Anything holding UTF-8 bytes converts without a copy
+    std::string stdStr("a b c");
+    REQUIRE( countSpaces(str) == 6 );
+    REQUIRE( countSpaces(stdStr) == 2 );
+    REQUIRE( countSpaces("a b") == 1 );
+    REQUIRE( UStringView(nullptr).size() == 0 );
+
+    UStringView sub = view.subStr(4, 5);
+    REQUIRE( sub == u8"ή ί ΰ" );
+    REQUIRE( sub.data() == view.data() + 6 );
+    REQUIRE( sub.length() == 5 );
+    REQUIRE( view.subStr(12) == "test" );
+    REQUIRE( view.subStr(30).size() == 0 );
+    REQUIRE( UString(sub) == u8"ή ί ΰ" );
+
+    REQUIRE( view.find(UChar(0x03B0)) == 8 );
+    REQUIRE( view.find(u8"ί ΰ") == 6 );
+    REQUIRE( view.find(u8"ί ΰ", 7) == UStringView::npos );
+    REQUIRE( view.find("t", 13) == 15 );
+    REQUIRE( view.find("x") == UStringView::npos );
+    REQUIRE( view.find(' ', 30) == UStringView::npos );
+    REQUIRE( view.findLastOf(' ') == 11 );
+    REQUIRE( view.findLastOf(UChar(0x03AD), 3) == 2 );
+    REQUIRE( view.findLastOf(u8"ΰ α") == 10 );
+    REQUIRE( view.findLastOf("t", 1) == 12 );
+    REQUIRE( view.findLastOf("test", 1) == UStringView::npos );
+
+    // Searching a UString with a view gives the same results as with a UString
+    REQUIRE( str.find(UStringView(u8"ί ΰ")) == str.find(UString(u8"ί ΰ")) );
+    REQUIRE( str.findLastOf(UStringView(u8"ΰ α")) == str.findLastOf(UString(u8"ΰ α")) );
+    REQUIRE( str.findLastOf(UStringView()) == UString::npos );
+    REQUIRE( view.findLastOf(UStringView()) == UStringView::npos );
+    REQUIRE( UString("abc").findLastOf("") == UString::npos );
+    REQUIRE( UStringView("abc").findLastOf("") == UStringView::npos );
+    REQUIRE( str.find(sub, UString::Position()).byteOffset() == 6 );
+
+    REQUIRE( UStringView("abc").compare("abd") < 0 );
+    REQUIRE( UStringView("abc").compare("ab") > 0 );
+    REQUIRE( UStringView("abc").compare(UString("abc")) == 0 );
+    REQUIRE( UStringView("abc") < UStringView("abcd") );
+    REQUIRE( UStringView("abc") != "abd" );
+
+    std::vector<UChar> reversed(view.rbegin(), view.rend());
+    REQUIRE( reversed.size() == 16 );
+    REQUIRE( reversed[15] == UChar(0x03AC) );
+
+    std::ostringstream stream;
+    stream << sub;
+    REQUIRE( stream.str() == u8"ή ί ΰ" );
+}
+
+TEST_CASE("Concurrent View Length", "[UStringView]")
+{
+    std::string bytes;
+    for( int i = 0; i < 5000; i++ )
+        bytes += u8"ά";
+
+    // The length of a shared const view is counted by whichever thread asks first
+    for( int round = 0; round < 20; round++ )
+    {
+        const UStringView view(bytes);
+        std::vector<int> mismatches(4, 0);
+        std::vector<std::thread> threads;
+        for( std::size_t t = 0; t < mismatches.size(); t++ )
+        {
+            threads.emplace_back([&view, &mismatches, t]()
+            {
+                mismatches[t] += ( view.length() != 5000 );
+                mismatches[t] += ( view.find(u8"άά", 4998) != 4998 );
+            });
+        }
+        for( auto& thread : threads )
+            thread.join();
+
+        REQUIRE( mismatches == std::vector<int>(mismatches.size(), 0) );
+    }
+}
+
+static std::vector<UString> fields(UStringSplitRange range)
+{
+    std::vector<UString> result;
+    for( UStringView field : range )
+        result.push_back(UString(field));
+    return result;
+}
+
+TEST_CASE("Split", "[UStringView]")
+{
+    UString line(u8"ά,έ,,ή ί,");
+    REQUIRE( fields(line.split(",")) == std::vector<UString>({ u8"ά", u8"έ", "", u8"ή ί", "" }) );
+    REQUIRE( fields(line.split(u8",έ,")) == std::vector<UString>({ u8"ά", u8",ή ί," }) );
+    REQUIRE( fields(line.split("x")) == std::vector<UString>({ line }) );
+    REQUIRE( fields(line.split("")) == std::vector<UString>({ line }) );
+    REQUIRE( fields(UStringView().split(",")) == std::vector<UString>({ "" }) );
+    REQUIRE( fields(UStringView(u8"a\tb\tc").split("\t")) == std::vector<UString>({ "a", "b", "c" }) );
+
+    // The fields point into the string that was split
+    UStringSplitRange range = line.split(",");
+    auto iter = range.begin();
+    REQUIRE( (*iter).data() == line.toStdString().data() );
+    ++iter;
+    REQUIRE( *iter == u8"έ" );
+    REQUIRE( (*iter).data() == line.toStdString().data() + 3 );
+
+    UCharSet spaces = UCharSet::fromPredicate(UChar::isSpace);
+    UString  text(u8"ά έ\u3000ή\tί  foo");
+    REQUIRE( fields(text.splitAny(spaces)) == std::vector<UString>({ u8"ά", u8"έ", u8"ή", u8"ί", "", "foo" }) );
+    REQUIRE( (*text.splitAny(spaces).begin()).length() == 1 );
+    REQUIRE( fields(text.splitAny(UCharSet(0x03AD, 0x03AE))) == std::vector<UString>({ u8"ά ", u8"\u3000", u8"\tί  foo" }) );
+
+    std::size_t count = 0;
+    for( UStringView field : UStringView("a,b,c").split(",") )
+        count += field.size();
+    REQUIRE( count == 3 );
+
+    // The range keeps copies of temporary delimiters
+    UString              mixed(u8"ά;έ,ή");
+    std::vector<UString> parts;
+    for( UStringView field : mixed.splitAny(UCharSet::fromRanges({ { ',', ',' }, { ';', ';' } })) )
+        parts.push_back(UString(field));
+    REQUIRE( parts == std::vector<UString>({ u8"ά", u8"έ", u8"ή" }) );
+
+    parts.clear();
+    for( UStringView field : line.split(UString(u8",έ,")) )
+        parts.push_back(UString(field));
+    REQUIRE( parts == std::vector<UString>({ u8"ά", u8",ή ί," }) );
+
+    // Splitting a temporary UString would leave the fields dangling
+    REQUIRE( canSplit<const UString&>(0) );
+    REQUIRE_FALSE( canSplit<UString>(0) );
+}
+
+#ifdef HAVE_CONSTEXPR
+// Validated and counted by the compiler
+constexpr UStringView LiteralKey = u8"ключ"_us;
+static_assert(LiteralKey.size() == 8, "literal size");
+#endif
+
+TEST_CASE("Literal", "[UStringView]")
+{
+    UStringView key = u8"ключ"_us;
+    REQUIRE( key.size() == 8 );
+    REQUIRE( key.length() == 4 );
+    REQUIRE( key == UStringView(u8"ключ") );
+    REQUIRE( UString(key).length() == 4 );
+    REQUIRE( UString(key) == u8"ключ" );
+
+    REQUIRE( ""_us.length() == 0 );
+    REQUIRE( "ascii"_us.length() == 5 );
+    REQUIRE( u8"aé€\U0001F600"_us.length() == 4 );
+    REQUIRE( UString(u8"aé€\U0001F600"_us).at(3) == UChar(0x1F600) );
+
+    // Literals that are not constant expressions are checked when they are evaluated
+    REQUIRE_THROWS_AS( operator"" _us("\xC3", 1), const utf8::invalid_utf8& );
+    REQUIRE_THROWS_AS( operator"" _us("a\x80", 2), const utf8::invalid_utf8& );
+    REQUIRE_THROWS_AS( operator"" _us("\xC0\xAF", 2), const utf8::invalid_utf8& );
+    REQUIRE_THROWS_AS( operator"" _us("\xE0\x80\xAF", 3), const utf8::invalid_utf8& );
+    REQUIRE_THROWS_AS( operator"" _us("\xED\xA0\x80", 3), const utf8::invalid_utf8& );
+    REQUIRE_THROWS_AS( operator"" _us("\xF4\x90\x80\x80", 4), const utf8::invalid_utf8& );
+    REQUIRE_THROWS_AS( operator"" _us("\xE2\x82", 2), const utf8::invalid_utf8& );
+    REQUIRE_THROWS_AS( operator"" _us("\xE2\x82\xAC\xAC", 4), const utf8::invalid_utf8& );
+}